@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/AddressIndex.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Register address range index for a single component.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <AddressIndex.hpp>
+#include <Register.hpp>
+
+using namespace std;
+
+AddressIndex::AddressIndex()
+{
+}
+
+AddressIndex::~AddressIndex()
+{
+}
+
+void AddressIndex::insert(Register* reg)
+{
+    if(reg)
+    {
+        mMap.insert(make_pair(reg->getAddr(), reg));
+    }
+}
+
+void AddressIndex::remove(Register* reg)
+{
+    if(reg)
+    {
+        erase(reg, reg->getAddr());
+    }
+}
+
+void AddressIndex::move(Register* reg, uint64_t oldAddr)
+{
+    erase(reg, oldAddr);
+    insert(reg);
+}
+
+void AddressIndex::erase(Register* reg, uint64_t address)
+{
+    pair<multimap<uint64_t, Register*>::iterator,
+        multimap<uint64_t, Register*>::iterator> range = mMap.equal_range(address);
+
+    multimap<uint64_t, Register*>::iterator it = range.first;
+    while(it != range.second)
+    {
+        if(it->second == reg)
+        {
+            mMap.erase(it++);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+Register* AddressIndex::find(uint64_t address) const
+{
+    multimap<uint64_t, Register*>::const_iterator it = mMap.find(address);
+    if(it != mMap.end())
+    {
+        return it->second;
+    }
+
+    return NULL;
+}
+
+uint64_t AddressIndex::getEnd(const Register& reg, int addressUnitBits)
+{
+    uint64_t units = 0;
+    if(addressUnitBits > 0 && reg.getWidth() > 0)
+    {
+        // Round partial units up, a 4bit register still occupies a byte.
+        units = (reg.getWidth() + addressUnitBits - 1) / addressUnitBits;
+    }
+
+    return reg.getAddr() + units * reg.getDimensions();
+}
+
+vector<pair<Register*, Register*> > AddressIndex::getOverlaps(int addressUnitBits) const
+{
+    vector<pair<Register*, Register*> > overlaps;
+
+    // Registers still covering the current address, in address order.
+    vector<pair<Register*, uint64_t> > open;
+
+    multimap<uint64_t, Register*>::const_iterator it;
+    for(it = mMap.begin(); it != mMap.end(); it++)
+    {
+        Register* reg = it->second;
+        uint64_t end = getEnd(*reg, addressUnitBits);
+
+        size_t kept = 0;
+        for(size_t i = 0; i < open.size(); i++)
+        {
+            if(open[i].second > it->first)
+            {
+                open[kept++] = open[i];
+            }
+        }
+        open.resize(kept);
+
+        if(end == reg->getAddr())
+        {
+            continue;
+        }
+
+        for(size_t i = 0; i < open.size(); i++)
+        {
+            if(open[i].first != reg)
+            {
+                overlaps.push_back(make_pair(open[i].first, reg));
+            }
+        }
+
+        open.push_back(make_pair(reg, end));
+    }
+
+    return overlaps;
+}
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/CompiledModel.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Frozen structure-of-arrays snapshot of the register model.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <CompiledModel.hpp>
+
+using namespace std;
+
+CompiledModel::CompiledModel(Components& components) : mSource(components)
+{
+    const vector<Component*>& componentList = components.get();
+    for(size_t i = 0; i < componentList.size(); i++)
+    {
+        if(componentList[i])
+        {
+            addComponent(*componentList[i]);
+        }
+    }
+}
+
+CompiledModel::~CompiledModel()
+{
+}
+
+void CompiledModel::addComponent(Component& component)
+{
+    size_t index = mComponentName.size();
+
+    mComponentName.push_back(component.getNameSymbol());
+    mComponentDescription.push_back(component.getDescriptionSymbol());
+    mComponentModuleName.push_back(StringPool::global().intern(component.getModuleName()));
+    mComponentBase.push_back(component.getBase());
+    mComponentRange.push_back(component.getRange());
+    mComponentAddressUnitBits.push_back(component.getAddressUnitBits());
+    mComponentTypeID.push_back(component.getTypeIDSymbol());
+    mComponentTypeIDCopy.push_back(component.isTypeIDCopy());
+    mComponentRegisters.push_back(Range());
+
+    Range registers;
+    registers.first = mRegisterName.size();
+
+    // Registers may have moved since they were inserted, sort once here so
+    // that writers never reorder a list they share with another thread.
+    component.sort();
+
+    const vector<Register*>& regs = component.get();
+    for(size_t i = 0; i < regs.size(); i++)
+    {
+        if(regs[i])
+        {
+            addRegister(*regs[i]);
+        }
+    }
+
+    registers.count = mRegisterName.size() - registers.first;
+    mComponentRegisters[index] = registers;
+}
+
+void CompiledModel::addRegister(Register& reg)
+{
+    size_t index = mRegisterName.size();
+
+    mRegisterName.push_back(reg.getNameSymbol());
+    mRegisterDescription.push_back(reg.getDescriptionSymbol());
+    mRegisterAddr.push_back(reg.getAddr());
+    mRegisterWidth.push_back(reg.getWidth());
+    mRegisterDimensions.push_back(reg.getDimensions());
+    mRegisterWords.push_back(Range());
+    mRegisterTypeID.push_back(reg.getTypeIDSymbol());
+    mRegisterTypeIDCopy.push_back(reg.isTypeIDCopy());
+    mRegisterFields.push_back(Range());
+
+    // Overlapping reset values depend on the field order.
+    reg.sort();
+
+    Range words;
+    words.first = mWordMask.size();
+    words.count = reg.getWords();
+    for(unsigned int word = 0; word < words.count; word++)
+    {
+        mWordResetValue.push_back(reg.getResetValue(word));
+        mWordResetUnknownMask.push_back(reg.getResetUnknownMask(word));
+        mWordMask.push_back(reg.getMask(word));
+        mWordWriteMask.push_back(reg.getWriteMask(word));
+    }
+    mRegisterWords[index] = words;
+
+    Range fields;
+    fields.first = mFieldName.size();
+
+    const vector<RegisterBitmap*>& bits = reg.get();
+    for(size_t i = 0; i < bits.size(); i++)
+    {
+        if(bits[i])
+        {
+            addField(*bits[i]);
+        }
+    }
+
+    fields.count = mFieldName.size() - fields.first;
+    mRegisterFields[index] = fields;
+}
+
+void CompiledModel::addField(RegisterBitmap& bitmap)
+{
+    size_t index = mFieldName.size();
+
+    unsigned char flags = 0;
+    if(bitmap.hasResetValue())      flags |= HasResetValue;
+    if(bitmap.isReserved())         flags |= IsReserved;
+    if(bitmap.isConstantValue())    flags |= IsConstantValue;
+
+    mFieldName.push_back(bitmap.getNameSymbol());
+    mFieldDescription.push_back(bitmap.getDescriptionSymbol());
+    mFieldStart.push_back(bitmap.getStart());
+    mFieldStop.push_back(bitmap.getStop());
+    mFieldMaskWords.push_back(Range());
+    mFieldType.push_back(bitmap.getType());
+    mFieldResetValue.push_back(bitmap.getResetValue());
+    mFieldResetUnknownMask.push_back(bitmap.getResetUnknownMask());
+    mFieldFlags.push_back(flags);
+    mFieldEnumerations.push_back(Range());
+
+    Range words;
+    words.first = mFieldWordMask.size();
+    words.count = bitmap.getStart() < 0 ? 1 : bitmap.getStart() / 64 + 1;
+    for(unsigned int word = 0; word < words.count; word++)
+    {
+        mFieldWordMask.push_back(bitmap.getMask(word));
+    }
+    mFieldMaskWords[index] = words;
+
+    Range enumerations;
+    enumerations.first = mEnumerationName.size();
+
+    bitmap.sort();
+
+    const vector<Enumeration*>& enums = bitmap.get();
+    for(size_t i = 0; i < enums.size(); i++)
+    {
+        if(enums[i])
+        {
+            addEnumeration(*enums[i]);
+        }
+    }
+
+    enumerations.count = mEnumerationName.size() - enumerations.first;
+    mFieldEnumerations[index] = enumerations;
+}
+
+void CompiledModel::addEnumeration(Enumeration& enumeration)
+{
+    mEnumerationName.push_back(enumeration.getNameSymbol());
+    mEnumerationDescription.push_back(enumeration.getDescriptionSymbol());
+    mEnumerationValue.push_back(enumeration.getValue());
+}
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/Diagnostics.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Leveled, buffered diagnostic messages.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Diagnostics.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mutex>
+
+using namespace std;
+
+// Buffered stdout text is written once it grows past this size.
+#define DIAGNOSTICS_BUFFER_SIZE     (64 * 1024)
+
+Diagnostics::Level Diagnostics::sVerbosity = Diagnostics::Status;
+
+static mutex gLock;
+static string gBuffer;
+static bool gRegistered = false;
+
+static thread_local DiagnosticsCapture* gCapture = NULL;
+
+// Called with gLock held.
+static void flush_buffer()
+{
+    if(!gBuffer.empty())
+    {
+        fwrite(gBuffer.data(), 1, gBuffer.size(), stdout);
+        fflush(stdout);
+        gBuffer.clear();
+    }
+}
+
+void Diagnostics::write(Level level, const string& message)
+{
+    if(gCapture)
+    {
+        DiagnosticsCapture::Message record = { level, message };
+        gCapture->mMessages.push_back(record);
+        return;
+    }
+
+    lock_guard<mutex> lock(gLock);
+    if(level <= Warning)
+    {
+        // Keep the order with the stdout messages before it.
+        flush_buffer();
+        fwrite(message.data(), 1, message.size(), stderr);
+        return;
+    }
+
+    registerExit();
+
+    gBuffer += message;
+    if(gBuffer.size() >= DIAGNOSTICS_BUFFER_SIZE)
+    {
+        flush_buffer();
+    }
+}
+
+void Diagnostics::vprint(Level level, const char* format, va_list args)
+{
+    if(!enabled(level))
+    {
+        return;
+    }
+
+    char text[256];
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(text, sizeof(text), format, copy);
+    va_end(copy);
+    if(length < 0)
+    {
+        return;
+    }
+
+    string message;
+    if((size_t)length < sizeof(text))
+    {
+        message.assign(text, length);
+    }
+    else
+    {
+        message.resize(length + 1);
+        vsnprintf(&message[0], message.size(), format, args);
+        message.resize(length);
+    }
+    message += '\n';
+
+    write(level, message);
+}
+
+#define DIAGNOSTICS_PRINT(__level__)        \
+    do {                                    \
+        if(enabled(__level__))              \
+        {                                   \
+            va_list args;                   \
+            va_start(args, format);         \
+            vprint(__level__, format, args);\
+            va_end(args);                   \
+        }                                   \
+    } while(0)
+
+void Diagnostics::print(Level level, const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(level);
+}
+
+void Diagnostics::error(const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(Error);
+}
+
+void Diagnostics::warning(const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(Warning);
+}
+
+void Diagnostics::status(const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(Status);
+}
+
+void Diagnostics::info(const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(Info);
+}
+
+void Diagnostics::debug(const char* format, ...)
+{
+    DIAGNOSTICS_PRINT(Debug);
+}
+
+void Diagnostics::flush()
+{
+    lock_guard<mutex> lock(gLock);
+    flush_buffer();
+}
+
+// Called with gLock held.
+void Diagnostics::registerExit()
+{
+    if(!gRegistered)
+    {
+        atexit(Diagnostics::exitHandler);
+        gRegistered = true;
+    }
+}
+
+// exit() may be called from captured work, print what it recorded first.
+void Diagnostics::exitHandler()
+{
+    vector<DiagnosticsCapture*> captures;
+    for(DiagnosticsCapture* capture = gCapture; capture; capture = capture->mPrevious)
+    {
+        captures.push_back(capture);
+    }
+    gCapture = NULL;
+
+    for(size_t i = captures.size(); i-- > 0; )
+    {
+        captures[i]->replay();
+    }
+
+    flush();
+}
+
+DiagnosticsCapture::DiagnosticsCapture() : mPrevious(NULL), mActive(false)
+{
+}
+
+DiagnosticsCapture::~DiagnosticsCapture()
+{
+    stop();
+}
+
+void DiagnosticsCapture::start()
+{
+    if(!mActive)
+    {
+        {
+            lock_guard<mutex> lock(gLock);
+            Diagnostics::registerExit();
+        }
+
+        mPrevious = gCapture;
+        gCapture = this;
+        mActive = true;
+    }
+}
+
+void DiagnosticsCapture::stop()
+{
+    if(mActive && gCapture == this)
+    {
+        gCapture = mPrevious;
+        mPrevious = NULL;
+        mActive = false;
+    }
+}
+
+void DiagnosticsCapture::replay()
+{
+    for(size_t i = 0; i < mMessages.size(); i++)
+    {
+        Diagnostics::write(mMessages[i].level, mMessages[i].text);
+    }
+    mMessages.clear();
+}
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/Mangler.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Identifier mangling shared by the writers.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Mangler.hpp>
+
+#include <ctype.h>
+#include <string.h>
+
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+// UTF-8 em dash, treated as '-'.
+static const char em_dash[] = "\xe2\x80\x94";
+
+#define SEPARATOR   "_"
+
+// Replacement for each byte, NULL keeps the byte.
+typedef const char* Table[256];
+
+struct Tables {
+    Table style[Mangler::StyleCount];
+    bool dash[Mangler::StyleCount];
+
+    Tables()
+    {
+        memset(style, 0, sizeof(style));
+        memset(dash, 0, sizeof(dash));
+
+        const char* separators = " -.,:[]";
+        for(const char* c = separators; *c; c++)
+        {
+            style[Mangler::Identifier][(unsigned char)*c] = SEPARATOR;
+            style[Mangler::CamelCase][(unsigned char)*c] = SEPARATOR;
+        }
+        style[Mangler::Identifier]['@'] = "_AT_";
+        style[Mangler::Identifier]['/'] = "_DIV_";
+        dash[Mangler::Identifier] = true;
+        dash[Mangler::CamelCase] = true;
+
+        memcpy(style[Mangler::Enumerator], style[Mangler::Identifier], sizeof(Table));
+        style[Mangler::Enumerator][' '] = "";
+        dash[Mangler::Enumerator] = true;
+
+        memcpy(style[Mangler::Assembler], style[Mangler::Identifier], sizeof(Table));
+        style[Mangler::Assembler]['-'] = NULL;
+
+        style[Mangler::LaTeX]['_'] = "\\_";
+        style[Mangler::LaTeX]['$'] = "\\$";
+    }
+};
+
+static const Tables gTables;
+
+string Mangler::mangle(const string& name, Style style)
+{
+    const Table& table = gTables.style[style];
+    bool dash = gTables.dash[style];
+    bool camel = style == CamelCase || style == Capitalized;
+
+    string result;
+    result.reserve(name.length());
+
+    bool needscap = true;
+    for(size_t i = 0; i < name.length(); i++)
+    {
+        unsigned char c = name[i];
+        const char* replacement = table[c];
+        if(dash && c == (unsigned char)em_dash[0] && name.compare(i, sizeof(em_dash) - 1, em_dash) == 0)
+        {
+            replacement = SEPARATOR;
+            i += sizeof(em_dash) - 2;
+        }
+
+        if(camel)
+        {
+            if(c == '_' || replacement)
+            {
+                needscap = true;
+            }
+            else
+            {
+                result += (char)(needscap ? toupper(c) : tolower(c));
+                needscap = false;
+            }
+        }
+        else if(replacement)
+        {
+            result += replacement;
+        }
+        else
+        {
+            result += (char)c;
+        }
+    }
+
+    return result;
+}
+
+const string& Mangler::get(const string& name, Style style)
+{
+    static mutex lock;
+    static unordered_map<string, string> cache[StyleCount];
+
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, string>::iterator it = cache[style].find(name);
+    if(it == cache[style].end())
+    {
+        it = cache[style].insert(make_pair(name, mangle(name, style))).first;
+    }
+    return it->second;
+}
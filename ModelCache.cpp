@@ -0,0 +1,649 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/ModelCache.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Binary cache of the parsed register model.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ModelCache.hpp>
+#include <Register.hpp>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+// Bump whenever the layout or meaning of a record changes.
+#define CACHE_VERSION   2
+#define CACHE_ENDIAN    0x01020304u
+
+static const char CACHE_MAGIC[8] = { 'I', 'P', 'X', 'C', 'A', 'C', 'H', 'E' };
+
+// On disk layout: header, then each record array in the order below, each
+// starting on an 8 byte boundary, then the string bytes. Records refer to
+// strings and to each other by index.
+struct CacheHeader {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    endian;
+    uint64_t    key;
+    uint64_t    size;
+    uint32_t    strings;
+    uint32_t    components;
+    uint32_t    registerRefs;
+    uint32_t    registers;
+    uint32_t    fields;
+    uint32_t    enumerations;
+    uint64_t    stringBytes;
+};
+
+struct CacheString {
+    uint32_t    offset;
+    uint32_t    length;
+};
+
+struct CacheComponent {
+    uint64_t    base;
+    uint32_t    name;
+    uint32_t    description;
+    uint32_t    typeID;
+    uint32_t    typeIDCopy;
+    uint32_t    moduleName;
+    int32_t     range;
+    int32_t     addressUnitBits;
+    uint32_t    firstRegister;  // Into the register reference array.
+    uint32_t    registerCount;
+    uint32_t    reserved;
+};
+
+struct CacheRegister {
+    uint64_t    address;
+    uint32_t    name;
+    uint32_t    description;
+    uint32_t    typeID;
+    uint32_t    typeIDCopy;
+    int32_t     width;
+    uint32_t    dimensions;
+    int32_t     parent;         // Component index, -1 if none.
+    uint32_t    firstField;
+    uint32_t    fieldCount;
+    uint32_t    reserved;
+};
+
+enum CacheFieldFlags {
+    CacheHasResetValue      = 1 << 0,
+    CacheIsReserved         = 1 << 1,
+    CacheIsConstantValue    = 1 << 2,
+};
+
+struct CacheField {
+    uint64_t    resetValue;
+    uint64_t    resetUnknownMask;
+    uint32_t    name;
+    uint32_t    description;
+    int32_t     start;
+    int32_t     stop;
+    uint32_t    type;
+    uint32_t    flags;
+    uint32_t    firstEnumeration;
+    uint32_t    enumerationCount;
+};
+
+struct CacheEnumeration {
+    uint64_t    value;
+    uint32_t    name;
+    uint32_t    description;
+};
+
+static size_t align8(size_t offset)
+{
+    return (offset + 7) & ~(size_t)7;
+}
+
+// Byte offsets of each section for the counts in the header.
+struct CacheLayout {
+    CacheLayout(const CacheHeader& header)
+    {
+        strings         = align8(sizeof(CacheHeader));
+        components      = align8(strings + header.strings * sizeof(CacheString));
+        registerRefs    = align8(components + header.components * sizeof(CacheComponent));
+        registers       = align8(registerRefs + header.registerRefs * sizeof(uint32_t));
+        fields          = align8(registers + header.registers * sizeof(CacheRegister));
+        enumerations    = align8(fields + header.fields * sizeof(CacheField));
+        stringBytes     = align8(enumerations + header.enumerations * sizeof(CacheEnumeration));
+        size            = stringBytes + header.stringBytes;
+    }
+
+    uint64_t strings;
+    uint64_t components;
+    uint64_t registerRefs;
+    uint64_t registers;
+    uint64_t fields;
+    uint64_t enumerations;
+    uint64_t stringBytes;
+    uint64_t size;
+};
+
+// 64bit FNV-1a
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t length)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+class CacheWriter
+{
+public:
+    CacheWriter()
+    {
+        memset(&mHeader, 0, sizeof(mHeader));
+    }
+
+    uint32_t addString(const string& str)
+    {
+        unordered_map<string, uint32_t>::const_iterator it = mStringIndex.find(str);
+        if(it != mStringIndex.end())
+        {
+            return it->second;
+        }
+
+        CacheString record;
+        record.offset = mStringBytes.size();
+        record.length = str.length();
+        mStringBytes += str;
+
+        uint32_t index = mStrings.size();
+        mStrings.push_back(record);
+        mStringIndex[str] = index;
+        return index;
+    }
+
+    void addComponent(Component& component, uint32_t index)
+    {
+        CacheComponent record;
+        memset(&record, 0, sizeof(record));
+        record.base             = component.getBase();
+        record.name             = addString(component.getName());
+        record.description      = addString(component.getDescription());
+        record.typeID           = addString(component.getTypeID());
+        record.typeIDCopy       = addString(component.getTypeIDCopy());
+        record.moduleName       = addString(component.getModuleName());
+        record.range            = component.getRange();
+        record.addressUnitBits  = component.getAddressUnitBits();
+        record.firstRegister    = mRegisterRefs.size();
+
+        const vector<Register*>& regs = component.get();
+        for(size_t i = 0; i < regs.size(); i++)
+        {
+            if(regs[i])
+            {
+                mRegisterRefs.push_back(addRegister(*regs[i]));
+            }
+        }
+
+        record.registerCount = mRegisterRefs.size() - record.firstRegister;
+        mComponents.push_back(record);
+        mComponentIndex[&component] = index;
+    }
+
+    // Parents are resolved once all components are known.
+    void resolveParents()
+    {
+        for(size_t i = 0; i < mRegisters.size(); i++)
+        {
+            unordered_map<const Component*, uint32_t>::const_iterator it =
+                mComponentIndex.find(mRegisterParents[i]);
+            mRegisters[i].parent = (it == mComponentIndex.end()) ? -1 : (int32_t)it->second;
+        }
+    }
+
+    bool write(FILE* file, uint64_t key)
+    {
+        memcpy(mHeader.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        mHeader.version         = CACHE_VERSION;
+        mHeader.endian          = CACHE_ENDIAN;
+        mHeader.key             = key;
+        mHeader.strings         = mStrings.size();
+        mHeader.components      = mComponents.size();
+        mHeader.registerRefs    = mRegisterRefs.size();
+        mHeader.registers       = mRegisters.size();
+        mHeader.fields          = mFields.size();
+        mHeader.enumerations    = mEnumerations.size();
+        mHeader.stringBytes     = mStringBytes.size();
+
+        CacheLayout layout(mHeader);
+        mHeader.size = layout.size;
+
+        uint64_t offset = 0;
+        return writeSection(file, offset, 0, &mHeader, sizeof(mHeader)) &&
+               writeSection(file, offset, layout.strings, mStrings.data(), mStrings.size() * sizeof(CacheString)) &&
+               writeSection(file, offset, layout.components, mComponents.data(), mComponents.size() * sizeof(CacheComponent)) &&
+               writeSection(file, offset, layout.registerRefs, mRegisterRefs.data(), mRegisterRefs.size() * sizeof(uint32_t)) &&
+               writeSection(file, offset, layout.registers, mRegisters.data(), mRegisters.size() * sizeof(CacheRegister)) &&
+               writeSection(file, offset, layout.fields, mFields.data(), mFields.size() * sizeof(CacheField)) &&
+               writeSection(file, offset, layout.enumerations, mEnumerations.data(), mEnumerations.size() * sizeof(CacheEnumeration)) &&
+               writeSection(file, offset, layout.stringBytes, mStringBytes.data(), mStringBytes.size());
+    }
+
+private:
+    uint32_t addRegister(Register& reg)
+    {
+        // Typed copies share registers, store each one once.
+        unordered_map<const Register*, uint32_t>::const_iterator it = mRegisterIndex.find(&reg);
+        if(it != mRegisterIndex.end())
+        {
+            return it->second;
+        }
+
+        CacheRegister record;
+        memset(&record, 0, sizeof(record));
+        record.address      = reg.getAddr();
+        record.name         = addString(reg.getName());
+        record.description  = addString(reg.getDescription());
+        record.typeID       = addString(reg.getTypeID());
+        record.typeIDCopy   = addString(reg.getTypeIDCopy());
+        record.width        = reg.getWidth();
+        record.dimensions   = reg.getDimensions();
+        record.firstField   = mFields.size();
+
+        const vector<RegisterBitmap*>& bits = reg.get();
+        for(size_t i = 0; i < bits.size(); i++)
+        {
+            if(bits[i])
+            {
+                addField(*bits[i]);
+            }
+        }
+        record.fieldCount = mFields.size() - record.firstField;
+
+        uint32_t index = mRegisters.size();
+        mRegisters.push_back(record);
+        mRegisterParents.push_back(reg.getParent());
+        mRegisterIndex[&reg] = index;
+        return index;
+    }
+
+    void addField(RegisterBitmap& bitmap)
+    {
+        CacheField record;
+        memset(&record, 0, sizeof(record));
+        record.resetValue       = bitmap.getResetValue();
+        record.resetUnknownMask = bitmap.getResetUnknownMask();
+        record.name             = addString(bitmap.getName());
+        record.description      = addString(bitmap.getDescription());
+        record.start            = bitmap.getStart();
+        record.stop             = bitmap.getStop();
+        record.type             = bitmap.getType();
+        record.flags            = (bitmap.hasResetValue() ? CacheHasResetValue : 0) |
+                                  (bitmap.isReserved() ? CacheIsReserved : 0) |
+                                  (bitmap.isConstantValue() ? CacheIsConstantValue : 0);
+        record.firstEnumeration = mEnumerations.size();
+
+        const vector<Enumeration*>& enums = bitmap.get();
+        for(size_t i = 0; i < enums.size(); i++)
+        {
+            if(enums[i])
+            {
+                CacheEnumeration enumeration;
+                memset(&enumeration, 0, sizeof(enumeration));
+                enumeration.value       = enums[i]->getValue();
+                enumeration.name        = addString(enums[i]->getName());
+                enumeration.description = addString(enums[i]->getDescription());
+                mEnumerations.push_back(enumeration);
+            }
+        }
+
+        record.enumerationCount = mEnumerations.size() - record.firstEnumeration;
+        mFields.push_back(record);
+    }
+
+    bool writeSection(FILE* file, uint64_t& offset, uint64_t start, const void* data, size_t length)
+    {
+        static const char padding[8] = { 0 };
+        if(start - offset > sizeof(padding) ||
+           fwrite(padding, 1, start - offset, file) != start - offset)
+        {
+            return false;
+        }
+
+        offset = start + length;
+        return !length || fwrite(data, 1, length, file) == length;
+    }
+
+    CacheHeader                 mHeader;
+    vector<CacheString>         mStrings;
+    string                      mStringBytes;
+    vector<CacheComponent>      mComponents;
+    vector<uint32_t>            mRegisterRefs;
+    vector<CacheRegister>       mRegisters;
+    vector<const Component*>    mRegisterParents;
+    vector<CacheField>          mFields;
+    vector<CacheEnumeration>    mEnumerations;
+
+    unordered_map<string, uint32_t>             mStringIndex;
+    unordered_map<const Component*, uint32_t>   mComponentIndex;
+    unordered_map<const Register*, uint32_t>    mRegisterIndex;
+};
+
+ModelCache::ModelCache(const string& directory) : mDirectory(directory), mKey(0)
+{
+}
+
+ModelCache::~ModelCache()
+{
+}
+
+bool ModelCache::computeKey(const vector<string>& inputs, bool mergeAddr, bool descriptions,
+                            const vector<string>& components)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint32_t version = CACHE_VERSION;
+    hash = hash_bytes(hash, &version, sizeof(version));
+    hash = hash_bytes(hash, &mergeAddr, sizeof(mergeAddr));
+    hash = hash_bytes(hash, &descriptions, sizeof(descriptions));
+
+    uint64_t count = components.size();
+    hash = hash_bytes(hash, &count, sizeof(count));
+    for(size_t i = 0; i < components.size(); i++)
+    {
+        hash = hash_bytes(hash, components[i].c_str(), components[i].length() + 1);
+    }
+
+    for(size_t i = 0; i < inputs.size(); i++)
+    {
+        int fd = open(inputs[i].c_str(), O_RDONLY);
+        struct stat info;
+        if(fd < 0 || fstat(fd, &info) != 0)
+        {
+            if(fd >= 0) close(fd);
+            return false;
+        }
+
+        // The name selects the reader, the contents the model.
+        uint64_t size = info.st_size;
+        hash = hash_bytes(hash, inputs[i].c_str(), inputs[i].length() + 1);
+        hash = hash_bytes(hash, &size, sizeof(size));
+
+        if(size)
+        {
+            void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data == MAP_FAILED)
+            {
+                close(fd);
+                return false;
+            }
+
+            hash = hash_bytes(hash, data, size);
+            munmap(data, size);
+        }
+        close(fd);
+    }
+
+    mKey = hash;
+
+    ostringstream path;
+    path << mDirectory << "/" << std::hex << mKey << ".ipxc";
+    mPath = path.str();
+
+    return true;
+}
+
+bool ModelCache::load(Components& components)
+{
+    if(mPath.empty())
+    {
+        return false;
+    }
+
+    int fd = open(mPath.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = info.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const char* base = (const char*)data;
+    const CacheHeader& header = *(const CacheHeader*)base;
+    CacheLayout layout(header);
+
+    bool valid = !memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) &&
+                 header.version == CACHE_VERSION &&
+                 header.endian == CACHE_ENDIAN &&
+                 header.key == mKey &&
+                 header.size == size &&
+                 layout.size == size;
+
+    const CacheString*      strings         = (const CacheString*)(base + layout.strings);
+    const CacheComponent*   componentList   = (const CacheComponent*)(base + layout.components);
+    const uint32_t*         registerRefs    = (const uint32_t*)(base + layout.registerRefs);
+    const CacheRegister*    registers       = (const CacheRegister*)(base + layout.registers);
+    const CacheField*       fields          = (const CacheField*)(base + layout.fields);
+    const CacheEnumeration* enumerations    = (const CacheEnumeration*)(base + layout.enumerations);
+    const char*             stringBytes     = base + layout.stringBytes;
+
+    // Check every reference before touching the model.
+    for(uint32_t i = 0; valid && i < header.strings; i++)
+    {
+        valid = (uint64_t)strings[i].offset + strings[i].length <= header.stringBytes;
+    }
+    for(uint32_t i = 0; valid && i < header.components; i++)
+    {
+        const CacheComponent& record = componentList[i];
+        valid = record.name < header.strings && record.description < header.strings &&
+                record.typeID < header.strings && record.typeIDCopy < header.strings &&
+                record.moduleName < header.strings &&
+                (uint64_t)record.firstRegister + record.registerCount <= header.registerRefs;
+    }
+    for(uint32_t i = 0; valid && i < header.registerRefs; i++)
+    {
+        valid = registerRefs[i] < header.registers;
+    }
+    for(uint32_t i = 0; valid && i < header.registers; i++)
+    {
+        const CacheRegister& record = registers[i];
+        valid = record.name < header.strings && record.description < header.strings &&
+                record.typeID < header.strings && record.typeIDCopy < header.strings &&
+                record.parent >= -1 && record.parent < (int64_t)header.components &&
+                (uint64_t)record.firstField + record.fieldCount <= header.fields;
+    }
+    for(uint32_t i = 0; valid && i < header.fields; i++)
+    {
+        const CacheField& record = fields[i];
+        valid = record.name < header.strings && record.description < header.strings &&
+                record.type <= RegisterBitmap::Reserved &&
+                (uint64_t)record.firstEnumeration + record.enumerationCount <= header.enumerations;
+    }
+    for(uint32_t i = 0; valid && i < header.enumerations; i++)
+    {
+        valid = enumerations[i].name < header.strings && enumerations[i].description < header.strings;
+    }
+
+    if(!valid)
+    {
+        munmap(data, size);
+        return false;
+    }
+
+    vector<Symbol> symbols(header.strings);
+    for(uint32_t i = 0; i < header.strings; i++)
+    {
+        symbols[i] = StringPool::global().intern(string(stringBytes + strings[i].offset, strings[i].length));
+    }
+
+    vector<Component*> componentObjects(header.components);
+    for(uint32_t i = 0; i < header.components; i++)
+    {
+        const CacheComponent& record = componentList[i];
+        Component* component = components.create<Component>(symbols[record.name].str());
+        component->setDescription(symbols[record.description].str());
+        component->setTypeID(symbols[record.typeID].str(), symbols[record.typeIDCopy].str());
+        component->setModuleName(symbols[record.moduleName].str());
+        component->setBase(record.base);
+        component->setRange(record.range);
+        component->setAddressUnitBits(record.addressUnitBits);
+        componentObjects[i] = component;
+    }
+
+    vector<Register*> registerObjects(header.registers);
+    for(uint32_t i = 0; i < header.registers; i++)
+    {
+        const CacheRegister& record = registers[i];
+        Register* reg = components.create<Register>(symbols[record.name].str());
+        reg->setDescription(symbols[record.description].str());
+        reg->setTypeID(symbols[record.typeID].str(), symbols[record.typeIDCopy].str());
+        reg->setWidth(record.width);
+        reg->setDimensions(record.dimensions);
+        reg->setAddr(record.address);
+        reg->setParent(record.parent < 0 ? NULL : componentObjects[record.parent]);
+
+        for(uint32_t j = record.firstField; j < record.firstField + record.fieldCount; j++)
+        {
+            const CacheField& field = fields[j];
+            RegisterBitmap* bitmap = components.create<RegisterBitmap>(symbols[field.name].str());
+            bitmap->setDescription(symbols[field.description].str());
+            bitmap->setStart(field.start);
+            bitmap->setStop(field.stop);
+            bitmap->setType((RegisterBitmap::Type)field.type);
+            bitmap->setReserved(field.flags & CacheIsReserved);
+            bitmap->setConstantValue(field.flags & CacheIsConstantValue);
+            if(field.flags & CacheHasResetValue)
+            {
+                bitmap->setResetValue(field.resetValue, field.resetUnknownMask);
+            }
+
+            for(uint32_t k = field.firstEnumeration; k < field.firstEnumeration + field.enumerationCount; k++)
+            {
+                Enumeration* enumeration = components.create<Enumeration>(symbols[enumerations[k].name].str());
+                enumeration->setDescription(symbols[enumerations[k].description].str());
+                enumeration->setValue(enumerations[k].value);
+                bitmap->set(enumeration->getName(), enumeration);
+            }
+
+            reg->set(bitmap->getName(), bitmap);
+        }
+
+        registerObjects[i] = reg;
+    }
+
+    for(uint32_t i = 0; i < header.components; i++)
+    {
+        const CacheComponent& record = componentList[i];
+        Component* component = componentObjects[i];
+        for(uint32_t j = record.firstRegister; j < record.firstRegister + record.registerCount; j++)
+        {
+            Register* reg = registerObjects[registerRefs[j]];
+            component->set(reg->getName(), reg);
+        }
+
+        components.set(component->getName(), component);
+    }
+
+    munmap(data, size);
+    return true;
+}
+
+bool ModelCache::save(Components& components)
+{
+    if(mPath.empty())
+    {
+        return false;
+    }
+
+    CacheWriter writer;
+    const vector<Component*>& componentList = components.get();
+    uint32_t index = 0;
+    for(size_t i = 0; i < componentList.size(); i++)
+    {
+        if(componentList[i])
+        {
+            writer.addComponent(*componentList[i], index++);
+        }
+    }
+    writer.resolveParents();
+
+    // Write to a private file first so concurrent runs never see a partial
+    // cache file.
+    ostringstream temp;
+    temp << mPath << ".tmp." << getpid();
+    string tempPath = temp.str();
+
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    bool status = writer.write(file, mKey);
+    status = (fclose(file) == 0) && status;
+
+    if(!status || rename(tempPath.c_str(), mPath.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
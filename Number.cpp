@@ -42,96 +42,421 @@
 /// @endcond
 ////////////////////////////////////////////////////////////////////////////////
 #include <Number.hpp>
+#include <Diagnostics.hpp>
 
+#include <limits.h>
 #include <stdio.h>
-#include <sstream>
-#include <algorithm>
-#include <iostream>
-#include <regex>
+#include <string.h>
 using namespace std;
 
-const char VERILOG_PARSER_REGEX[]  = "\\s*([0-9]+)'([hbdo])([0-9A-Fa-f_]+)\\s*";
-const char NUMBER_PARSER_REGEX[]  = "^\\s*([0]?[xX]?)([0-9A-Fa-f]+)\\s*$";
+// Upper bound on the declared width of a Verilog literal.
+#define NUMBER_MAX_WIDTH    65536u
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static bool is_decimal(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Returns the value of a hex digit, or -1.
+static int digit_value(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool is_hex(char c)
+{
+    return digit_value(c) >= 0;
+}
+
+// Accumulates leading digits valid in base, skipping '_' when allowed.
+// Parsing stops at the first other character, overflow saturates.
+static uint64_t parse_digits(const char* begin, const char* end, unsigned int base, bool underscores)
+{
+    uint64_t value = 0;
+    for(const char* p = begin; p != end; p++)
+    {
+        if(underscores && *p == '_')
+        {
+            continue;
+        }
+
+        int digit = digit_value(*p);
+        if(digit < 0 || digit >= (int)base)
+        {
+            break;
+        }
+
+        if(value > (UINT64_MAX - digit) / base)
+        {
+            return UINT64_MAX;
+        }
+        value = value * base + digit;
+    }
+
+    return value;
+}
+
+Number::Number(const char* numstring)
+{
+    parse(numstring, numstring ? numstring + strlen(numstring) : NULL);
+}
+
+Number::Number(const char* numstring, size_t length)
+{
+    parse(numstring, numstring ? numstring + length : NULL);
+}
 
 Number::Number(const string& numstring)
+{
+    parse(numstring.data(), numstring.data() + numstring.length());
+}
+
+void Number::parse(const char* begin, const char* end)
 {
     mValid = false;
+    mTruncated = false;
     mWidth = 0;
     mValue = 0;
+    mXMask = 0;
+    mZMask = 0;
+
+    if(!begin)
+    {
+        return;
+    }
+
+    if(!parseVerilog(begin, end))
+    {
+        parseNumber(begin, end);
+    }
+}
+
+bool Number::hasUnknown() const
+{
+    for(unsigned int i = 0; i < getWords(); i++)
+    {
+        if(getXMask(i) || getZMask(i))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Number::resize(unsigned int words)
+{
+    words = words ? words - 1 : 0;
+    mWideValue.resize(words);
+    mWideXMask.resize(words);
+    mWideZMask.resize(words);
+}
+
+// Ors count (<= 64) bits of value in at the given bit, the storage must
+// already be large enough.
+void Number::setBits(unsigned int bit, unsigned int count, uint64_t value, uint64_t& word0, vector<uint64_t>& wide)
+{
+    value &= (count < 64) ? ((1ull << count) - 1) : ~0ull;
+
+    unsigned int word = bit / 64;
+    unsigned int shift = bit % 64;
+    (word ? wide[word - 1] : word0) |= value << shift;
+    if(shift && shift + count > 64)
+    {
+        wide[word] |= value >> (64 - shift);
+    }
+}
+
+// value = value * factor + addend across all words.
+void Number::multiplyAdd(unsigned int factor, unsigned int addend)
+{
+    uint64_t carry = addend;
+    for(unsigned int i = 0; i < getWords(); i++)
+    {
+        uint64_t& word = i ? mWideValue[i - 1] : mValue;
+        uint64_t low  = (word & 0xFFFFFFFF) * factor + carry;
+        uint64_t high = (word >> 32) * factor + (low >> 32);
+        word = (high << 32) | (low & 0xFFFFFFFF);
+        carry = high >> 32;
+    }
+}
+
+// Drops bits at or above width, returns with the minimum number of words.
+void Number::truncate(unsigned int width)
+{
+    unsigned int words = (width + 63) / 64;
+    for(unsigned int i = 0; i < getWords(); i++)
+    {
+        uint64_t keep = 0;
+        if(i < words)
+        {
+            keep = ((i + 1) * 64 <= width) ? ~0ull : ((1ull << (width % 64)) - 1);
+        }
+
+        uint64_t& value = i ? mWideValue[i - 1] : mValue;
+        uint64_t& x     = i ? mWideXMask[i - 1] : mXMask;
+        uint64_t& z     = i ? mWideZMask[i - 1] : mZMask;
+        if((value | x | z) & ~keep)
+        {
+            mTruncated = true;
+        }
+        value &= keep;
+        x &= keep;
+        z &= keep;
+    }
+
+    resize(words);
+}
+
+static bool is_verilog_digit(char c)
+{
+    return is_hex(c) || c == '_' || c == 'x' || c == 'X' || c == 'z' || c == 'Z' || c == '?';
+}
+
+static bool is_x(char c)
+{
+    return c == 'x' || c == 'X';
+}
+
+static bool is_z(char c)
+{
+    return c == 'z' || c == 'Z' || c == '?';
+}
 
-    static regex verregex(VERILOG_PARSER_REGEX);
-    static regex numregex(NUMBER_PARSER_REGEX);
-    smatch match;
-    if(regex_search(numstring, match, verregex) && match.size() > 1)
+// Matches <width>'<h|b|d|o><digits> anywhere in the string. Digits may
+// contain '_' separators and x / z / ? for unknown or high impedance bits.
+bool Number::parseVerilog(const char* begin, const char* end)
+{
+    for(const char* quote = begin; quote != end; quote++)
     {
-        const string& bits   = match.str(1);
-        const string& type   = match.str(2);
-        const string& valstr = match.str(3);
+        if(*quote != '\'')
+        {
+            continue;
+        }
 
-        // remove all '_'
-        string no_under(valstr);
-        std::remove(no_under.begin(), no_under.end(), '_');
+        const char* bits = quote;
+        while(bits != begin && is_decimal(bits[-1]))
+        {
+            bits--;
+        }
 
-        stringstream(bits) >> mWidth;
+        const char* valstr = quote + 2;
+        if(bits == quote || valstr > end || !quote[1] || !strchr("hbdo", quote[1]) ||
+           valstr == end || !is_verilog_digit(*valstr))
+        {
+            continue;
+        }
+
+        const char* valend = valstr;
+        while(valend != end && is_verilog_digit(*valend))
+        {
+            valend++;
+        }
+
+        uint64_t width = parse_digits(bits, quote, 10, false);
+        if(width > NUMBER_MAX_WIDTH)
+        {
+            Diagnostics::error("Error: literal '%.*s' is wider than %u bits.",
+                (int)(valend - bits), bits, NUMBER_MAX_WIDTH);
+            return true;
+        }
+        mWidth = width;
         mValid = true;
-        // fixme
-        if(type == "h")
+
+        unsigned int base;
+        unsigned int digitBits;
+        switch(quote[1])
         {
-            stringstream(no_under) >> std::hex >> mValue;
+            case 'h': base = 16; digitBits = 4; break;
+            case 'o': base = 8;  digitBits = 3; break;
+            case 'b': base = 2;  digitBits = 1; break;
+            default:  base = 10; digitBits = 4; break;
         }
-        else if(type == "o")
+
+        // As before, digits invalid for the base end the value. Binary
+        // literals instead report each invalid digit.
+        unsigned int digits = 0;
+        const char* last = valstr;
+        for(; last != valend; last++)
         {
-            stringstream(no_under) >> std::oct >> mValue;
+            if(*last == '_')
+            {
+                continue;
+            }
+
+            int digit = digit_value(*last);
+            if(digit >= (int)base || (digit < 0 && base == 10 && digits))
+            {
+                if(base != 2)
+                {
+                    break;
+                }
+
+                Diagnostics::error("Invalid binary character '%c'", *last);
+                mValid = false;
+            }
+            digits++;
         }
-        else if(type == "d")
+
+        unsigned int valueBits = digits * digitBits;
+        unsigned int extent = valueBits > mWidth ? valueBits : mWidth;
+        resize((extent + 63) / 64);
+
+        const char* msd = valstr;
+        while(msd != last && *msd == '_')
         {
-            stringstream(no_under) >> std::dec >> mValue;
+            msd++;
         }
-        else if(type == "b")
+
+        if(base == 10)
         {
-            int bit = 0;
-            for ( string::const_reverse_iterator it=no_under.rbegin(); it!=no_under.rend(); ++it)
+            if(msd != last && (is_x(*msd) || is_z(*msd)))
             {
-                if(*it == '1')
+                // A decimal x or z digit makes the whole value unknown.
+                unsigned int count = mWidth ? mWidth : 64;
+                resize((count + 63) / 64);
+                for(unsigned int bit = 0; bit < count; bit += 64)
                 {
-                    mValue += (1 << bit);
+                    unsigned int n = count - bit < 64 ? count - bit : 64;
+                    if(is_x(*msd)) setBits(bit, n, ~0ull, mXMask, mWideXMask);
+                    else           setBits(bit, n, ~0ull, mZMask, mWideZMask);
                 }
-                else if(*it != '0')
+
+                for(const char* p = msd + 1; p != last; p++)
+                {
+                    if(*p != '_' && *p != *msd)
+                    {
+                        Diagnostics::error("Error: literal '%.*s' mixes x or z with decimal digits.",
+                            (int)(valend - bits), bits);
+                        mValid = false;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                for(const char* p = msd; p != last; p++)
                 {
-                    fprintf(stderr, "Invalid binary character '%c'", *it);
-                    mValid = false;
+                    if(*p != '_')
+                    {
+                        multiplyAdd(10, digit_value(*p));
+                    }
                 }
-                bit++;
             }
         }
         else
         {
-            fprintf(stderr, "Error: unable to handle base format of '%s'\n", type.c_str());
-            mValid = false;
-        }
-    }
-    else if(regex_search(numstring, match, numregex) && match.size() > 1)
-    {
-        mValid = true;
-        const string& type   = match.str(1);
-        const string& valstr = match.str(2);
+            unsigned int bit = 0;
+            for(const char* p = last; p != msd; )
+            {
+                char c = *--p;
+                if(c == '_')
+                {
+                    continue;
+                }
 
-        if(type == "")
-        {
-            stringstream(valstr) >> std::dec >> mValue;
+                if(is_x(c))
+                {
+                    setBits(bit, digitBits, ~0ull, mXMask, mWideXMask);
+                }
+                else if(is_z(c))
+                {
+                    setBits(bit, digitBits, ~0ull, mZMask, mWideZMask);
+                }
+                else if(digit_value(c) < (int)base)
+                {
+                    setBits(bit, digitBits, digit_value(c), mValue, mWideValue);
+                }
+                bit += digitBits;
+            }
+
+            // A leading x or z digit fills the rest of the declared width.
+            if(msd != last && (is_x(*msd) || is_z(*msd)))
+            {
+                for(; bit < mWidth; bit += 64)
+                {
+                    unsigned int n = mWidth - bit < 64 ? mWidth - bit : 64;
+                    if(is_x(*msd)) setBits(bit, n, ~0ull, mXMask, mWideXMask);
+                    else           setBits(bit, n, ~0ull, mZMask, mWideZMask);
+                }
+            }
         }
-        else if(type == "0x" || type == "0X")
+
+        if(mWidth)
         {
-            stringstream(valstr) >> std::hex >> mValue;
+            truncate(mWidth);
+            if(mTruncated)
+            {
+                Diagnostics::warning("Warning: literal '%.*s' does not fit in %u bits, truncating.",
+                    (int)(valend - bits), bits, mWidth);
+            }
         }
-        else if(type == "0")
+        else
         {
-            stringstream(valstr) >> std::oct >> mValue;
+            unsigned int words = getWords();
+            while(words > 1 && !getValue(words - 1) && !getXMask(words - 1) && !getZMask(words - 1))
+            {
+                words--;
+            }
+            resize(words);
         }
-        else
+
+        return true;
+    }
+
+    return false;
+}
+
+// Matches a whole C style decimal, 0 prefixed octal, or 0x prefixed hex number.
+void Number::parseNumber(const char* begin, const char* end)
+{
+    while(begin != end && is_space(*begin))
+    {
+        begin++;
+    }
+    while(end != begin && is_space(end[-1]))
+    {
+        end--;
+    }
+
+    for(const char* p = begin; p != end; p++)
+    {
+        if(!is_hex(*p) && !((*p == 'x' || *p == 'X') && p - begin < 2))
         {
-            fprintf(stderr, "Error: unable to handle base format of '%s'\n", type.c_str());
-            mValid = false;
+            return;
         }
     }
+
+    size_t length = end - begin;
+    if(length >= 3 && begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X'))
+    {
+        begin += 2;
+        if(!is_hex(*begin)) return;
+        mValid = true;
+        mValue = parse_digits(begin, end, 16, false);
+    }
+    else if(length >= 2 && (begin[0] == 'x' || begin[0] == 'X'))
+    {
+        if(!is_hex(begin[1])) return;
+        Diagnostics::error("Error: unable to handle base format of '%c'", begin[0]);
+    }
+    else if(length >= 2 && begin[0] == '0')
+    {
+        if(!is_hex(begin[1])) return;
+        mValid = true;
+        mValue = parse_digits(begin + 1, end, 8, false);
+    }
+    else if(length >= 1 && is_hex(begin[0]) && (length == 1 || is_hex(begin[1])))
+    {
+        mValid = true;
+        mValue = parse_digits(begin, end, 10, false);
+    }
 }
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/OutputFile.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Generated file output.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <OutputFile.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <sstream>
+
+using namespace std;
+
+#define OUTPUT_COMPARE_SIZE     (64 * 1024)
+
+static atomic<unsigned int> gCount(0);
+static atomic<unsigned int> gUpdated(0);
+
+bool OutputFile::matches(const string& path, const string& contents)
+{
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode) || (size_t)info.st_size != contents.size())
+    {
+        return false;
+    }
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+    {
+        return false;
+    }
+
+    char buffer[OUTPUT_COMPARE_SIZE];
+    size_t offset = 0;
+    bool same = true;
+    while(same && offset < contents.size())
+    {
+        size_t length = fread(buffer, 1, sizeof(buffer), file);
+        same = length && offset + length <= contents.size() &&
+               memcmp(buffer, contents.data() + offset, length) == 0;
+        offset += length;
+    }
+
+    // The file may have grown since stat().
+    same = same && fgetc(file) == EOF;
+    fclose(file);
+    return same;
+}
+
+bool OutputFile::write(const string& path, const string& contents)
+{
+    gCount++;
+    if(matches(path, contents))
+    {
+        return true;
+    }
+
+    // Write a private copy first so readers never see a partial file.
+    ostringstream temp;
+    temp << path << ".tmp." << getpid();
+    string tempPath = temp.str();
+
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    bool status = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    status = (fclose(file) == 0) && status;
+
+    // Keep the permissions of the file being replaced.
+    struct stat info;
+    if(status && stat(path.c_str(), &info) == 0)
+    {
+        chmod(tempPath.c_str(), info.st_mode & 07777);
+    }
+
+    if(!status || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    gUpdated++;
+    return true;
+}
+
+unsigned int OutputFile::getCount()
+{
+    return gCount;
+}
+
+unsigned int OutputFile::getUpdated()
+{
+    return gUpdated;
+}
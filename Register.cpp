@@ -50,11 +50,13 @@ using namespace std;
 
 Register::Register(const string& name) : Container<RegisterBitmap>(name)
 {
-    mName = name;
+    setName(name);
     mWidth = 0;
     mAddress = 0;
-    mDescription = "";
+    setDescription("");
     mDimensions = 1;
+    mCacheValid = false;
+    mParent = NULL;
 }
 
 Register::~Register()
@@ -65,11 +67,44 @@ Register::~Register()
 void Register::setWidth(int width)
 {
     mWidth = width;
+    mCacheValid = false;
 }
 
 void Register::setAddr(uint64_t addr)
 {
-    mAddress = addr;
+    if(addr != mAddress)
+    {
+        uint64_t oldAddr = mAddress;
+        mAddress = addr;
+
+        for(size_t i = 0; i < mOwners.size(); i++)
+        {
+            mOwners[i]->updateAddress(this, oldAddr);
+        }
+    }
+}
+
+void Register::setTypeID(const std::string& type, const std::string &copy)
+{
+    Container<RegisterBitmap>::setTypeID(type, copy);
+
+    for(size_t i = 0; i < mOwners.size(); i++)
+    {
+        mOwners[i]->updateTypeID(this);
+    }
+}
+
+void Register::addOwner(Component* component)
+{
+    if(std::find(mOwners.begin(), mOwners.end(), component) == mOwners.end())
+    {
+        mOwners.push_back(component);
+    }
+}
+
+void Register::removeOwner(Component* component)
+{
+    mOwners.erase(std::remove(mOwners.begin(), mOwners.end(), component), mOwners.end());
 }
 
 void Register::setDimensions(unsigned int dim)
@@ -77,120 +112,163 @@ void Register::setDimensions(unsigned int dim)
     mDimensions = dim;
 }
 
-unsigned int Register::getResetValue() const
+unsigned int Register::getWords() const
 {
-    unsigned int resetValue = 0;
-
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
-        it != mList.end(); ++it)
-    {
-        RegisterBitmap *pField = *it;
+    if(!mCacheValid) updateCache();
+    return mMask.size();
+}
 
-        if(pField->hasResetValue())
-        {
-            unsigned int mask = pField->getMask();
-            int stop = pField->getStop();
+uint64_t Register::getResetValue(unsigned int word) const
+{
+    if(!mCacheValid) updateCache();
+    return word < mResetValue.size() ? mResetValue[word] : 0;
+}
 
-            resetValue &= ~mask;
-            resetValue |= (pField->getResetValue() << stop) & mask;
-        }
-    }
+uint64_t Register::getResetUnknownMask(unsigned int word) const
+{
+    if(!mCacheValid) updateCache();
+    return word < mResetUnknownMask.size() ? mResetUnknownMask[word] : 0;
+}
 
-    return resetValue;
+uint64_t Register::getWriteMask(unsigned int word) const
+{
+    if(!mCacheValid) updateCache();
+    return word < mWriteMask.size() ? mWriteMask[word] : 0;
 }
 
-unsigned int Register::getWriteMask() const
+uint64_t Register::getMask(unsigned int word) const
 {
-    unsigned int mask = 0;
+    if(!mCacheValid) updateCache();
+    return word < mMask.size() ? mMask[word] : 0;
+}
 
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
+void Register::updateCache() const
+{
+    size_t words = mWidth > 64 ? (mWidth + 63) / 64 : 1;
+    for(std::vector<RegisterBitmap*>::const_iterator it = mList.begin();
         it != mList.end(); ++it)
     {
         RegisterBitmap *pField = *it;
-
-        if(RegisterBitmap::ReadOnly != pField->getType() &&
-            !pField->isReserved())
+        if(pField->getStart() >= (int)words * 64)
         {
-            mask |= pField->getMask();
+            words = pField->getStart() / 64 + 1;
         }
     }
 
-    return mask;
-}
-
-unsigned int Register::getMask() const
-{
-    unsigned int mask = 0;
+    mResetValue.assign(words, 0);
+    mResetUnknownMask.assign(words, 0);
+    mWriteMask.assign(words, 0);
+    mMask.assign(words, 0);
+    unsigned int flags = 0;
 
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
+    for(std::vector<RegisterBitmap*>::const_iterator it = mList.begin();
         it != mList.end(); ++it)
     {
         RegisterBitmap *pField = *it;
+        int stop = pField->getStop();
+        int start = pField->getStart();
+        if(stop < 0 || start < stop)
+        {
+            continue;
+        }
 
+        bool isWrite = false;
         if(!pField->isReserved())
         {
-            mask |= pField->getMask();
+            switch(pField->getType())
+            {
+                case RegisterBitmap::ReadOnly:
+                    flags |= HasReadOnly;
+                    break;
+                case RegisterBitmap::WriteOnly:
+                    flags |= HasWriteOnly | HasWrite;
+                    isWrite = true;
+                    break;
+                default:
+                    flags |= HasWrite;
+                    isWrite = true;
+                    break;
+            }
         }
-    }
 
-    return mask;
-}
+        uint64_t resetValue = pField->getResetValue() & pField->getFieldMask();
+        uint64_t resetUnknown = pField->getResetUnknownMask() & pField->getFieldMask();
+        for(int word = stop / 64; word <= start / 64; word++)
+        {
+            uint64_t fieldMask = pField->getMask(word);
 
-bool Register::hasReadOnly() const
-{
-    bool isReadOnly = false;
+            if(pField->hasResetValue())
+            {
+                // Later fields take precedence where fields overlap.
+                int offset = word * 64 - stop;
+                uint64_t value = offset >= 64 ? 0 :
+                                 offset >= 0  ? resetValue >> offset :
+                                                resetValue << -offset;
+                uint64_t unknown = offset >= 64 ? 0 :
+                                   offset >= 0  ? resetUnknown >> offset :
+                                                  resetUnknown << -offset;
+
+                mResetValue[word] &= ~fieldMask;
+                mResetValue[word] |= value & fieldMask;
+                mResetUnknownMask[word] &= ~fieldMask;
+                mResetUnknownMask[word] |= unknown & fieldMask;
+            }
 
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
-        it != mList.end(); ++it)
-    {
-        RegisterBitmap *pField = *it;
+            if(!pField->isReserved())
+            {
+                mMask[word] |= fieldMask;
+            }
 
-        if(RegisterBitmap::ReadOnly == pField->getType() &&
-            !pField->isReserved())
-        {
-            isReadOnly = true;
+            if(isWrite)
+            {
+                mWriteMask[word] |= fieldMask;
+            }
         }
     }
 
-    return isReadOnly;
+    mAccessFlags = flags;
+    mCacheValid = true;
 }
 
-bool Register::hasWriteOnly() const
+void Register::set(const std::string& name, RegisterBitmap* element)
 {
-    bool isWriteOnly = false;
+    Container<RegisterBitmap>::set(name, element);
 
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
-        it != mList.end(); ++it)
+    if(element)
     {
-        RegisterBitmap *pField = *it;
-
-        if(RegisterBitmap::WriteOnly == pField->getType() &&
-            !pField->isReserved())
-        {
-            isWriteOnly = true;
-        }
+        element->addOwner(this);
     }
-
-    return isWriteOnly;
+    mCacheValid = false;
 }
 
-bool Register::hasWrite() const
+void Register::remove(const std::string& name, RegisterBitmap* element)
 {
-    bool isWrite = false;
+    Container<RegisterBitmap>::remove(name, element);
 
-    for(std::list<RegisterBitmap*>::const_iterator it = mList.begin();
-        it != mList.end(); ++it)
+    if(element)
     {
-        RegisterBitmap *pField = *it;
+        element->removeOwner(this);
+    }
+    mCacheValid = false;
+}
 
-        if(RegisterBitmap::ReadOnly != pField->getType() &&
-            !pField->isReserved())
+void Register::clear()
+{
+    for(size_t i = 0; i < mList.size(); i++)
+    {
+        if(mList[i])
         {
-            isWrite = true;
+            mList[i]->removeOwner(this);
         }
     }
 
-    return isWrite;
+    Container<RegisterBitmap>::clear();
+    mCacheValid = false;
+}
+
+void Register::updateBitmap(RegisterBitmap* bitmap)
+{
+    mCacheValid = false;
 }
 
 bool compare_bitmaps(const RegisterBitmap* first, const RegisterBitmap* second)
@@ -201,7 +279,11 @@ bool compare_bitmaps(const RegisterBitmap* first, const RegisterBitmap* second)
 
 void Register::sort()
 {
-    mList.sort(compare_bitmaps);
+    // Overlapping reset values depend on the field order.
+    if(sortList(compare_bitmaps))
+    {
+        mCacheValid = false;
+    }
 }
 
 
@@ -209,8 +291,8 @@ void Register::sort()
 
 Component::Component(const std::string& name) : Container<Register>(name)
 {
-    mName = name;
-    mDescription = "";
+    setName(name);
+    setDescription("");
     mRange = 0;
     mAddressUnitBits = 8;
 }
@@ -227,43 +309,118 @@ bool compare_regs(const Register* first, const Register* second)
 
 void Component::sort()
 {
-    mList.sort(compare_regs);
+    sortList(compare_regs);
 }
 
 
+bool Component::sharesRegisters()
+{
+    const vector<Register*>& regs = get();
+    for(size_t i = 0; i < regs.size(); i++)
+    {
+        if(regs[i] && regs[i]->getParent() != this)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 Register* Component::get(uint64_t address)
 {
-    const std::list<Register*>& regs = Container<Register>::get();
-    std::list<Register*>::const_iterator it;
+    return mAddresses.find(address);
+}
 
-    for(it = regs.begin(); it != regs.end(); it++)
+void Component::set(const std::string& name, Register* element)
+{
+    if(element && Container<Register>::get(name) == element)
     {
-        Register* reg = *it;
-        if(reg && reg->getAddr() == address) return reg;
+        return;
+    }
+
+    Container<Register>::set(name, element);
+
+    if(element)
+    {
+        if(!element->getParent())
+        {
+            element->setParent(this);
+        }
+
+        mAddresses.insert(element);
+        indexTypeID(element);
+        element->addOwner(this);
     }
-    return NULL;
 }
 
-Register* Component::getElementWithTypeID(std::string &typeID)
+void Component::remove(const std::string& name, Register* element)
 {
-    Register* element = NULL;
-    if(!typeID.empty())
+    Container<Register>::remove(name, element);
+
+    if(element)
     {
-        // See if any existing components exist with the given type, and if so, copy it.
-        auto it = mMap.begin();
-        for(; it != mMap.end(); it++)
+        if(element->getParent() == this)
         {
-            element = it->second;
-            if(element)
-            {
-                if(element->getTypeID() == typeID)
-                {
-                    return element;
-                }
-            }
+            element->setParent(NULL);
+        }
+
+        mAddresses.remove(element);
+        unindexTypeID(element);
+        element->removeOwner(this);
+    }
+}
+
+void Component::clear()
+{
+    for(size_t i = 0; i < mList.size(); i++)
+    {
+        if(mList[i])
+        {
+            mList[i]->removeOwner(this);
         }
     }
-    return NULL;
+
+    Container<Register>::clear();
+    mAddresses.clear();
+}
+
+void Component::setTypeID(const std::string& type, const std::string &copy)
+{
+    Container<Register>::setTypeID(type, copy);
+
+    for(size_t i = 0; i < mOwners.size(); i++)
+    {
+        mOwners[i]->updateTypeID(this);
+    }
+}
+
+void Component::updateAddress(Register* reg, uint64_t oldAddr)
+{
+    mAddresses.move(reg, oldAddr);
+}
+
+void Component::updateTypeID(Register* reg)
+{
+    indexTypeID(reg);
+}
+
+void Component::addOwner(Components* components)
+{
+    if(std::find(mOwners.begin(), mOwners.end(), components) == mOwners.end())
+    {
+        mOwners.push_back(components);
+    }
+}
+
+void Component::removeOwner(Components* components)
+{
+    mOwners.erase(std::remove(mOwners.begin(), mOwners.end(), components), mOwners.end());
+}
+
+Register* Component::getElementWithTypeID(std::string &typeID)
+{
+    return findTypeID(typeID);
 }
 
 
@@ -279,8 +436,10 @@ RegisterBitmap::RegisterBitmap(const std::string& name) :
     mType = RegisterBitmap::ReadWrite;
     mHasResetValue = false;
     mResetValue = 0;
+    mResetUnknownMask = 0;
     mReserved = false;
     mConstantValue = false;
+    updateMask();
 }
 
 RegisterBitmap::RegisterBitmap(const std::string& name,
@@ -293,8 +452,10 @@ RegisterBitmap::RegisterBitmap(const std::string& name,
     mType = type;
     mHasResetValue = false;
     mResetValue = 0;
+    mResetUnknownMask = 0;
     mReserved = false;
     mConstantValue = false;
+    updateMask();
 }
 
 bool compare_enums(const Enumeration* first, const Enumeration* second)
@@ -305,18 +466,41 @@ bool compare_enums(const Enumeration* first, const Enumeration* second)
 
 void RegisterBitmap::sort()
 {
-    mList.sort(compare_enums);
+    sortList(compare_enums);
+}
+
+void RegisterBitmap::setStart(int start)
+{
+    mStartBit = start;
+    updateMask();
+    changed();
+}
+
+void RegisterBitmap::setStop(int stop)
+{
+    mStopBit = stop;
+    updateMask();
+    changed();
+}
+
+void RegisterBitmap::setType(RegisterBitmap::Type type)
+{
+    mType = type;
+    changed();
 }
 
-void RegisterBitmap::setResetValue(unsigned int resetValue)
+void RegisterBitmap::setResetValue(uint64_t resetValue, uint64_t unknownMask)
 {
     mHasResetValue = true;
-    mResetValue = resetValue;
+    mResetValue = resetValue & ~unknownMask;
+    mResetUnknownMask = unknownMask;
+    changed();
 }
 
 void RegisterBitmap::setReserved(bool reserved)
 {
     mReserved = reserved;
+    changed();
 }
 
 void RegisterBitmap::setConstantValue(bool constant)
@@ -324,16 +508,65 @@ void RegisterBitmap::setConstantValue(bool constant)
     mConstantValue = constant;
 }
 
-unsigned int RegisterBitmap::getMask() const
+void RegisterBitmap::addOwner(Register* reg)
 {
-    unsigned int mask = 0;
+    if(std::find(mOwners.begin(), mOwners.end(), reg) == mOwners.end())
+    {
+        mOwners.push_back(reg);
+    }
+}
+
+void RegisterBitmap::removeOwner(Register* reg)
+{
+    mOwners.erase(std::remove(mOwners.begin(), mOwners.end(), reg), mOwners.end());
+}
+
+// Bits stop..start of a 64bit word, built from two shifts instead of a per
+// bit loop. Bits outside of the word are dropped.
+static uint64_t word_mask(int stop, int start)
+{
+    if(stop < 0) stop = 0;
+    if(start > 63) start = 63;
+    if(start < stop)
+    {
+        return 0;
+    }
+
+    return (~0ull >> (63 - start)) & (~0ull << stop);
+}
+
+uint64_t RegisterBitmap::getMask(unsigned int word) const
+{
+    if(mStopBit < 0)
+    {
+        return 0;
+    }
 
-    for(int i = getStop(); i <= getStart(); ++i)
+    return word_mask(mStopBit - (int)word * 64, mStartBit - (int)word * 64);
+}
+
+uint64_t RegisterBitmap::getFieldMask() const
+{
+    int width = mStartBit - mStopBit + 1;
+    if(width <= 0)
     {
-        mask |= 1 << i;
+        return 0;
     }
 
-    return mask;
+    return width >= 64 ? ~0ull : (1ull << width) - 1;
+}
+
+void RegisterBitmap::updateMask()
+{
+    mMask = getMask(0);
+}
+
+void RegisterBitmap::changed()
+{
+    for(size_t i = 0; i < mOwners.size(); i++)
+    {
+        mOwners[i]->updateBitmap(this);
+    }
 }
 
 //////
@@ -341,8 +574,8 @@ unsigned int RegisterBitmap::getMask() const
 Enumeration::Enumeration(const std::string& name) : Container<int>(name),
     mValue(0)
 {
-    mName = name;
-    mDescription = "";
+    setName(name);
+    setDescription("");
 }
 
 void Enumeration::sort()
@@ -354,34 +587,195 @@ void Enumeration::sort()
 
 Components::Components() : Container<Component>("all")
 {
-    mName = "";
-    mDescription = "";
+    setName("");
+    setDescription("");
 }
 
 Components::~Components()
 {
+    release();
+}
 
+void Components::release()
+{
+    for(size_t i = 0; i < mList.size(); i++)
+    {
+        if(mList[i])
+        {
+            mList[i]->removeOwner(this);
+        }
+    }
+    clear();
+
+    mComponentPool.release();
+    mRegisterPool.release();
+    mBitmapPool.release();
+    mEnumerationPool.release();
+
+    for(size_t i = 0; i < mAdopted.size(); i++)
+    {
+        delete mAdopted[i];
+    }
+    mAdopted.clear();
 }
 
-Component* Components::getElementWithTypeID(std::string &typeID)
+void Components::adopt(Components* other)
 {
-    Component* element = NULL;
-    if(!typeID.empty())
+    std::vector<Component*> list = other->get();
+    for(size_t i = 0; i < list.size(); i++)
     {
-        // See if any existing components exist with the given type, and if so, copy it.
-        auto it = mMap.begin();
-        for(; it != mMap.end(); it++)
+        if(list[i])
         {
-            element = it->second;
-            if(element)
+            list[i]->removeOwner(other);
+        }
+    }
+    other->clear();
+
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        if(list[i])
+        {
+            set(list[i]->getName(), list[i]);
+        }
+    }
+
+    mAdopted.push_back(other);
+}
+
+Register* Components::clone(Register& reg)
+{
+    Register* copy = create<Register>(reg.getName());
+    copy->setDescription(reg.getDescription());
+    copy->setTypeID(reg.getTypeID(), reg.getTypeIDCopy());
+    copy->setWidth(reg.getWidth());
+    copy->setDimensions(reg.getDimensions());
+    copy->setAddr(reg.getAddr());
+
+    const std::vector<RegisterBitmap*>& bits = reg.get();
+    for(size_t i = 0; i < bits.size(); i++)
+    {
+        RegisterBitmap* bit = bits[i];
+        if(!bit)
+        {
+            continue;
+        }
+
+        RegisterBitmap* bitCopy = create<RegisterBitmap>(bit->getName());
+        bitCopy->setDescription(bit->getDescription());
+        bitCopy->setStart(bit->getStart());
+        bitCopy->setStop(bit->getStop());
+        bitCopy->setType(bit->getType());
+        bitCopy->setReserved(bit->isReserved());
+        bitCopy->setConstantValue(bit->isConstantValue());
+        if(bit->hasResetValue())
+        {
+            bitCopy->setResetValue(bit->getResetValue(), bit->getResetUnknownMask());
+        }
+
+        const std::vector<Enumeration*>& enums = bit->get();
+        for(size_t j = 0; j < enums.size(); j++)
+        {
+            Enumeration* enumeration = enums[j];
+            if(enumeration)
             {
-                if(element->getTypeID() == typeID)
-                {
-                    return element;
-                }
+                Enumeration* enumCopy = create<Enumeration>(enumeration->getName());
+                enumCopy->setDescription(enumeration->getDescription());
+                enumCopy->setValue(enumeration->getValue());
+                bitCopy->set(enumCopy->getName(), enumCopy);
             }
         }
+
+        copy->set(bitCopy->getName(), bitCopy);
     }
-    return NULL;
+
+    return copy;
+}
+
+Register* Components::unshare(Component& component, Register* reg)
+{
+    if(!reg || reg->getParent() == &component)
+    {
+        return reg;
+    }
+
+    Register* unshared = NULL;
+
+    // Copy, the list is modified below.
+    vector<Register*> regs = component.get();
+    for(size_t i = 0; i < regs.size(); i++)
+    {
+        Register* shared = regs[i];
+        if(shared && shared->getParent() != &component)
+        {
+            Register* copy = clone(*shared);
+            component.remove(shared->getName(), shared);
+            component.set(copy->getName(), copy);
+
+            if(shared == reg) unshared = copy;
+        }
+    }
+
+    if(component.isTypeIDCopy())
+    {
+        // No longer identical to the type's source component.
+        component.setTypeID("", "");
+    }
+
+    return unshared;
+}
+
+void Components::unshare(Component& component)
+{
+    const vector<Register*>& regs = component.get();
+    for(size_t i = 0; i < regs.size(); i++)
+    {
+        if(regs[i] && regs[i]->getParent() != &component)
+        {
+            unshare(component, regs[i]);
+            return;
+        }
+    }
+
+    if(component.isTypeIDCopy())
+    {
+        component.setTypeID("", "");
+    }
+}
+
+Component* Components::getElementWithTypeID(std::string &typeID)
+{
+    return findTypeID(typeID);
+}
+
+void Components::set(const std::string& name, Component* element)
+{
+    if(element && Container<Component>::get(name) == element)
+    {
+        return;
+    }
+
+    Container<Component>::set(name, element);
+
+    if(element)
+    {
+        indexTypeID(element);
+        element->addOwner(this);
+    }
+}
+
+void Components::remove(const std::string& name, Component* element)
+{
+    Container<Component>::remove(name, element);
+
+    if(element)
+    {
+        unindexTypeID(element);
+        element->removeOwner(this);
+    }
+}
+
+void Components::updateTypeID(Component* component)
+{
+    indexTypeID(component);
 }
 
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/StringPool.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Interned string symbols.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <StringPool.hpp>
+
+using namespace std;
+
+StringPool::StringPool()
+{
+}
+
+StringPool& StringPool::global()
+{
+    static StringPool pool;
+    return pool;
+}
+
+Symbol StringPool::intern(const string& str)
+{
+    if(str.empty())
+    {
+        return Symbol();
+    }
+
+    {
+        shared_lock<shared_timed_mutex> lock(mLock);
+        unordered_set<string>::const_iterator it = mStrings.find(str);
+        if(it != mStrings.end())
+        {
+            return Symbol(&*it);
+        }
+    }
+
+    lock_guard<shared_timed_mutex> lock(mLock);
+    return Symbol(&*mStrings.insert(str).first);
+}
+
+bool StringPool::find(const string& str, Symbol& symbol) const
+{
+    if(str.empty())
+    {
+        symbol = Symbol();
+        return true;
+    }
+
+    shared_lock<shared_timed_mutex> lock(mLock);
+    unordered_set<string>::const_iterator it = mStrings.find(str);
+    if(it == mStrings.end())
+    {
+        return false;
+    }
+
+    symbol = Symbol(&*it);
+    return true;
+}
+
+size_t StringPool::size() const
+{
+    shared_lock<shared_timed_mutex> lock(mLock);
+    return mStrings.size();
+}
@@ -59,7 +59,7 @@ public:
     APESimulatorWriter(const char* filename);
     ~APESimulatorWriter();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
 
 protected:
     virtual std::string serialize_bitmap_declaration(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth);
@@ -79,10 +79,11 @@ protected:
     virtual std::string& escape(std::string &str);
     virtual std::string& escapeEnum(std::string &str);
 private:
+    APESimulatorWriter(const APESimulatorWriter& parent);
+
     int mIndent;
     char* mFilename;
 
-    void strreplace(std::string& origstr, const std::string& find, const std::string& replace);
     std::string getComponentFile(const char* componentname);
     std::string getComponentAPEFile(const char* componentname);
 
@@ -58,15 +58,15 @@ public:
     ASMSymbols(const char* filename);
     ~ASMSymbols();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
+    virtual bool usesCompiledModelOnly() const { return true; }
 
 protected:
-    virtual std::string serialize_component_declaration(Component& component);
+    virtual std::string serialize_component_declaration(const CompiledModel& model, size_t component);
 
 private:
     char* mFilename;
 
-    void strreplace(std::string& origstr, const std::string& find, const std::string& replace);
 };
 
 #endif /* !ASMSYMBOLS_H */
@@ -58,18 +58,19 @@ public:
     ASMWriter(const char* filename);
     ~ASMWriter();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
+    virtual bool usesCompiledModelOnly() const { return true; }
 
 protected:
-    virtual std::string serialize_bitmap_definition(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth);
-    virtual std::string serialize_bitmap_declaration(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth);
+    virtual std::string serialize_bitmap_definition(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, int regwidth);
+    virtual std::string serialize_bitmap_declaration(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, int regwidth);
 
-    virtual std::string serialize_enum_definition(Component& component, Register& reg, RegisterBitmap& bitmap, Enumeration& thisenum);
+    virtual std::string serialize_enum_definition(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, size_t thisenum);
 
-    virtual std::string serialize_register_definition(Component& component, Register& reg);
-    virtual std::string serialize_register_declaration(Component& component, Register& reg);
+    virtual std::string serialize_register_definition(const CompiledModel& model, size_t component, size_t reg);
+    virtual std::string serialize_register_declaration(const CompiledModel& model, size_t component, size_t reg);
 
-    virtual std::string serialize_component_declaration(Component& component);
+    virtual std::string serialize_component_declaration(const CompiledModel& model, size_t component);
 
     virtual std::string camelcase(const std::string& str);
 
@@ -82,7 +83,6 @@ private:
     int mIndent;
     char* mFilename;
 
-    void strreplace(std::string& origstr, const std::string& find, const std::string& replace);
 };
 
 #endif /* !ASMWRITER_H */
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/AddressIndex.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Register address range index for a single component.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ADDRESSINDEX_HPP
+#define ADDRESSINDEX_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class Register;
+
+class AddressIndex
+{
+public:
+    AddressIndex();
+    ~AddressIndex();
+
+    void insert(Register* reg);
+    void remove(Register* reg);
+
+    // Re-key a register whose start address changed from oldAddr.
+    void move(Register* reg, uint64_t oldAddr);
+
+    // First register starting at exactly the given address.
+    Register* find(uint64_t address) const;
+
+    // Address just past the last unit covered by a register, including
+    // all array dimensions.
+    static uint64_t getEnd(const Register& reg, int addressUnitBits);
+
+    // Single sweep over the registers in address order, returning every
+    // pair whose ranges intersect. Each pair lists the register starting first.
+    std::vector<std::pair<Register*, Register*> > getOverlaps(int addressUnitBits) const;
+
+    void clear() { mMap.clear(); }
+    size_t size() const { return mMap.size(); }
+
+private:
+    void erase(Register* reg, uint64_t address);
+
+    std::multimap<uint64_t, Register*> mMap;
+};
+
+#endif /* !ADDRESSINDEX_HPP */
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/Arena.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Typed bump allocator pools.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <stddef.h>
+
+#include <new>
+#include <utility>
+#include <vector>
+
+// Objects are constructed in place into fixed size blocks and are only
+// destroyed when the whole pool is released.
+template <class T> class ArenaPool {
+public:
+    ArenaPool(size_t blockSize = 256) : mBlockSize(blockSize), mUsed(blockSize) { }
+    ~ArenaPool() { release(); }
+
+    template <class... Args> T* create(Args&&... args)
+    {
+        if(mUsed == mBlockSize)
+        {
+            mBlocks.push_back(static_cast<T*>(::operator new(sizeof(T) * mBlockSize)));
+            mUsed = 0;
+        }
+
+        T* element = new (mBlocks.back() + mUsed) T(std::forward<Args>(args)...);
+        mUsed++;
+        return element;
+    }
+
+    void release()
+    {
+        // Destroy in reverse order of construction, the last block is only
+        // partially used.
+        while(!mBlocks.empty())
+        {
+            T* block = mBlocks.back();
+            while(mUsed)
+            {
+                block[--mUsed].~T();
+            }
+
+            ::operator delete(block);
+            mBlocks.pop_back();
+
+            // Earlier blocks are full.
+            mUsed = mBlockSize;
+        }
+    }
+
+    size_t size() const
+    {
+        return mBlocks.empty() ? 0 : (mBlocks.size() - 1) * mBlockSize + mUsed;
+    }
+
+private:
+    ArenaPool(const ArenaPool&);
+    ArenaPool& operator=(const ArenaPool&);
+
+    std::vector<T*> mBlocks;
+    size_t          mBlockSize;
+    size_t          mUsed;
+};
+
+#endif /* !ARENA_HPP */
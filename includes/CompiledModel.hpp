@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/CompiledModel.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Frozen structure-of-arrays snapshot of the register model.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMPILEDMODEL_HPP
+#define COMPILEDMODEL_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include <Register.hpp>
+#include <StringPool.hpp>
+
+// Immutable copy of a Components list, built once after all inputs were
+// read. Every element kind is stored as parallel arrays indexed by
+// position, parents refer to their children through [first, first+count)
+// index ranges. Elements appear in the order writers traverse them:
+// registers by address, fields by start bit and enumerations by value.
+//
+// Only const accessors are provided, so one snapshot can be shared by
+// several writers or threads.
+class CompiledModel
+{
+public:
+    struct Range {
+        Range() : first(0), count(0) { }
+
+        size_t begin() const { return first; }
+        size_t end() const { return first + count; }
+        bool empty() const { return !count; }
+
+        size_t first;
+        size_t count;
+    };
+
+    CompiledModel(Components& components);
+    ~CompiledModel();
+
+    // Source model, for writers that still traverse the component tree. Its
+    // lists are sorted while the snapshot is built and must not be modified
+    // afterwards.
+    const Components& getComponents() const { return mSource; }
+
+    // Components.
+    size_t getComponentCount() const { return mComponentName.size(); }
+    const std::string& getComponentName(size_t i) const { return mComponentName[i].str(); }
+    const std::string& getComponentDescription(size_t i) const { return mComponentDescription[i].str(); }
+    const std::string& getComponentModuleName(size_t i) const { return mComponentModuleName[i].str(); }
+    uint64_t getComponentBase(size_t i) const { return mComponentBase[i]; }
+    int getComponentRange(size_t i) const { return mComponentRange[i]; }
+    int getComponentAddressUnitBits(size_t i) const { return mComponentAddressUnitBits[i]; }
+    const std::string& getComponentTypeID(size_t i) const { return mComponentTypeID[i].str(); }
+    bool isComponentTypeIDCopy(size_t i) const { return mComponentTypeIDCopy[i]; }
+    const Range& getComponentRegisters(size_t i) const { return mComponentRegisters[i]; }
+
+    // Registers.
+    size_t getRegisterCount() const { return mRegisterName.size(); }
+    const std::string& getRegisterName(size_t i) const { return mRegisterName[i].str(); }
+    const std::string& getRegisterDescription(size_t i) const { return mRegisterDescription[i].str(); }
+    uint64_t getRegisterAddr(size_t i) const { return mRegisterAddr[i]; }
+    int getRegisterWidth(size_t i) const { return mRegisterWidth[i]; }
+    unsigned int getRegisterDimensions(size_t i) const { return mRegisterDimensions[i]; }
+    // Aggregates are kept per 64bit word, word 0 holding the least
+    // significant bits. Words past the register read as 0.
+    unsigned int getRegisterWords(size_t i) const { return mRegisterWords[i].count; }
+    uint64_t getRegisterResetValue(size_t i, unsigned int word = 0) const { return wordAt(mWordResetValue, mRegisterWords[i], word); }
+    uint64_t getRegisterResetUnknownMask(size_t i, unsigned int word = 0) const { return wordAt(mWordResetUnknownMask, mRegisterWords[i], word); }
+    uint64_t getRegisterMask(size_t i, unsigned int word = 0) const { return wordAt(mWordMask, mRegisterWords[i], word); }
+    uint64_t getRegisterWriteMask(size_t i, unsigned int word = 0) const { return wordAt(mWordWriteMask, mRegisterWords[i], word); }
+    const std::string& getRegisterTypeID(size_t i) const { return mRegisterTypeID[i].str(); }
+    bool isRegisterTypeIDCopy(size_t i) const { return mRegisterTypeIDCopy[i]; }
+    const Range& getRegisterFields(size_t i) const { return mRegisterFields[i]; }
+
+    // Fields.
+    size_t getFieldCount() const { return mFieldName.size(); }
+    const std::string& getFieldName(size_t i) const { return mFieldName[i].str(); }
+    const std::string& getFieldDescription(size_t i) const { return mFieldDescription[i].str(); }
+    int getFieldStart(size_t i) const { return mFieldStart[i]; }
+    int getFieldStop(size_t i) const { return mFieldStop[i]; }
+    // Number of 64bit words up to and including the field's top bit.
+    unsigned int getFieldWords(size_t i) const { return mFieldMaskWords[i].count; }
+    uint64_t getFieldMask(size_t i, unsigned int word = 0) const { return wordAt(mFieldWordMask, mFieldMaskWords[i], word); }
+    RegisterBitmap::Type getFieldType(size_t i) const { return mFieldType[i]; }
+    bool hasFieldResetValue(size_t i) const { return mFieldFlags[i] & HasResetValue; }
+    uint64_t getFieldResetValue(size_t i) const { return mFieldResetValue[i]; }
+    uint64_t getFieldResetUnknownMask(size_t i) const { return mFieldResetUnknownMask[i]; }
+    bool isFieldReserved(size_t i) const { return mFieldFlags[i] & IsReserved; }
+    bool isFieldConstantValue(size_t i) const { return mFieldFlags[i] & IsConstantValue; }
+    const Range& getFieldEnumerations(size_t i) const { return mFieldEnumerations[i]; }
+
+    // Enumerations.
+    size_t getEnumerationCount() const { return mEnumerationName.size(); }
+    const std::string& getEnumerationName(size_t i) const { return mEnumerationName[i].str(); }
+    const std::string& getEnumerationDescription(size_t i) const { return mEnumerationDescription[i].str(); }
+    uint64_t getEnumerationValue(size_t i) const { return mEnumerationValue[i]; }
+
+private:
+    enum FieldFlags {
+        HasResetValue   = 1 << 0,
+        IsReserved      = 1 << 1,
+        IsConstantValue = 1 << 2,
+    };
+
+    CompiledModel(const CompiledModel&);
+    CompiledModel& operator=(const CompiledModel&);
+
+    void addComponent(Component& component);
+    void addRegister(Register& reg);
+    void addField(RegisterBitmap& bitmap);
+    void addEnumeration(Enumeration& enumeration);
+
+    static uint64_t wordAt(const std::vector<uint64_t>& words, const Range& range, unsigned int word)
+    {
+        return word < range.count ? words[range.first + word] : 0;
+    }
+
+    Components& mSource;
+
+    std::vector<Symbol>                 mComponentName;
+    std::vector<Symbol>                 mComponentDescription;
+    std::vector<Symbol>                 mComponentModuleName;
+    std::vector<uint64_t>               mComponentBase;
+    std::vector<int>                    mComponentRange;
+    std::vector<int>                    mComponentAddressUnitBits;
+    std::vector<Symbol>                 mComponentTypeID;
+    std::vector<bool>                   mComponentTypeIDCopy;
+    std::vector<Range>                  mComponentRegisters;
+
+    std::vector<Symbol>                 mRegisterName;
+    std::vector<Symbol>                 mRegisterDescription;
+    std::vector<uint64_t>               mRegisterAddr;
+    std::vector<int>                    mRegisterWidth;
+    std::vector<unsigned int>           mRegisterDimensions;
+    std::vector<Range>                  mRegisterWords;
+    std::vector<Symbol>                 mRegisterTypeID;
+    std::vector<bool>                   mRegisterTypeIDCopy;
+    std::vector<Range>                  mRegisterFields;
+
+    std::vector<Symbol>                 mFieldName;
+    std::vector<Symbol>                 mFieldDescription;
+    std::vector<int>                    mFieldStart;
+    std::vector<int>                    mFieldStop;
+    std::vector<Range>                  mFieldMaskWords;
+    std::vector<RegisterBitmap::Type>   mFieldType;
+    std::vector<uint64_t>               mFieldResetValue;
+    std::vector<uint64_t>               mFieldResetUnknownMask;
+    std::vector<unsigned char>          mFieldFlags;
+    std::vector<Range>                  mFieldEnumerations;
+
+    std::vector<Symbol>                 mEnumerationName;
+    std::vector<Symbol>                 mEnumerationDescription;
+    std::vector<uint64_t>               mEnumerationValue;
+
+    // Per word register aggregates and field masks.
+    std::vector<uint64_t>               mWordResetValue;
+    std::vector<uint64_t>               mWordResetUnknownMask;
+    std::vector<uint64_t>               mWordMask;
+    std::vector<uint64_t>               mWordWriteMask;
+    std::vector<uint64_t>               mFieldWordMask;
+};
+
+#endif /* !COMPILEDMODEL_HPP */
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/Diagnostics.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Leveled, buffered diagnostic messages.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIAGNOSTICS_HPP
+#define DIAGNOSTICS_HPP
+
+#include <stdarg.h>
+
+#include <string>
+#include <vector>
+
+// Messages for the user, filtered by level. Errors and warnings go to
+// stderr right away. Other levels are buffered and written to stdout in
+// large blocks, at flush() or at exit. Each message is one line, the
+// newline is added.
+class Diagnostics
+{
+public:
+    enum Level {
+        Error,
+        Warning,
+        Status,     // Progress, shown by default.
+        Info,       // -v
+        Debug,      // -vv, per element tracing.
+    };
+
+    static void setVerbosity(Level level) { sVerbosity = level; }
+    static bool enabled(Level level) { return level <= sVerbosity; }
+
+    static void print(Level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+    static void vprint(Level level, const char* format, va_list args);
+
+    static void error(const char* format, ...) __attribute__((format(printf, 1, 2)));
+    static void warning(const char* format, ...) __attribute__((format(printf, 1, 2)));
+    static void status(const char* format, ...) __attribute__((format(printf, 1, 2)));
+    static void info(const char* format, ...) __attribute__((format(printf, 1, 2)));
+    static void debug(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+    static void flush();
+
+private:
+    friend class DiagnosticsCapture;
+
+    static void write(Level level, const std::string& message);
+
+    static void registerExit();
+    static void exitHandler();
+
+    static Level sVerbosity;
+};
+
+// Records the messages of one thread between start() and stop() instead of
+// printing them, so work done in parallel can report in a fixed order.
+class DiagnosticsCapture
+{
+public:
+    DiagnosticsCapture();
+    ~DiagnosticsCapture();
+
+    void start();
+    void stop();
+
+    // Prints the recorded messages and forgets them.
+    void replay();
+
+private:
+    friend class Diagnostics;
+
+    struct Message {
+        Diagnostics::Level level;
+        std::string text;
+    };
+
+    std::vector<Message> mMessages;
+    DiagnosticsCapture*  mPrevious;
+    bool                 mActive;
+};
+
+#endif /* !DIAGNOSTICS_HPP */
@@ -58,7 +58,7 @@ public:
     HeaderWriter(const char* filename);
     ~HeaderWriter();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
 
     virtual std::string camelcase(const std::string& str);
     virtual std::string serialize_bitmap_declaration(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth);
@@ -88,10 +88,11 @@ protected:
     virtual std::string& escape(std::string &str);
     virtual std::string& escapeEnum(std::string &str);
 private:
+    HeaderWriter(const std::string& filename);
+
     int mIndent;
     char* mFilename;
 
-    void strreplace(std::string& origstr, const std::string& find, const std::string& replace);
     std::string getComponentFile(const char* componentname);
     bool writeComponent(Component &component);
 
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/IPXACTIndex.hpp
+///
+/// @project    ipxact
+///
+/// @brief      IP-XACT address block index.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IPXACTINDEX_HPP
+#define IPXACTINDEX_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+// Byte ranges of the ipxact:addressBlock elements in an input file, so
+// selected components can be parsed without reading the rest of the file.
+// An index is tied to the size and modification time of its input.
+class IPXACTIndex
+{
+public:
+    struct Block {
+        size_t begin;
+        size_t end;
+
+        // The ipxact:addressUnitBits element used by the block, empty if none.
+        size_t unitsBegin;
+        size_t unitsEnd;
+
+        std::string name;
+        std::string typeID;
+    };
+
+    IPXACTIndex(uint64_t size, int64_t seconds, int64_t nanoseconds);
+    ~IPXACTIndex();
+
+    // Returns false if the file is missing, damaged or for another version
+    // of the input.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    void add(const Block& block) { mBlocks.push_back(block); }
+    const std::vector<Block>& get() const { return mBlocks; }
+
+    // Blocks for the named components and the components their types are
+    // copied from, in file order.
+    std::vector<const Block*> select(const std::set<std::string>& names) const;
+
+private:
+    uint64_t mSize;
+    int64_t  mSeconds;
+    int64_t  mNanoseconds;
+
+    std::vector<Block> mBlocks;
+};
+
+#endif /* !IPXACTINDEX_HPP */
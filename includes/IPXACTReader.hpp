@@ -45,10 +45,14 @@
 #ifndef IPXACTREADER_H
 #define IPXACTREADER_H
 
+#include <IPXACTIndex.hpp>
 #include <Reader.hpp>
+#include <XMLArena.hpp>
 
 #include <pugixml.hpp>
 
+#include <string>
+
 class IPXACTReader : public Reader
 {
 public:
@@ -58,19 +62,61 @@ public:
 
     virtual bool read();
 
+    enum Tag {
+        TagUnknown,
+        TagAccess,
+        TagAddressBlock,
+        TagAddressOffset,
+        TagAddressUnitBits,
+        TagBaseAddress,
+        TagBitOffset,
+        TagBitWidth,
+        TagDescription,
+        TagDim,
+        TagEnumeratedValue,
+        TagEnumeratedValues,
+        TagField,
+        TagName,
+        TagRange,
+        TagRegister,
+        TagResets,
+        TagSize,
+        TagTypeIdentifier,
+        TagValue,
+        TagVendorExtensions,
+    };
+
+    // Maps an element name to its tag without allocating.
+    static Tag classify(const char* name);
+
 private:
+    // Streaming mode, only one ipxact:addressBlock is held in memory.
+    bool readStream();
+
+    // Only the address blocks of the --component list are parsed.
+    bool readSelected();
+    bool scanBlocks(const char* data, size_t size, IPXACTIndex* index);
+    void describeBlock(const char* begin, const char* content, const char* end, IPXACTIndex::Block& block);
+    bool parseBlock(const char* begin, const char* end, const char* unitsBegin, const char* unitsEnd);
+    bool parseFragment(pugi::xml_document& doc, const char* begin, const char* end);
+
     virtual bool parseElement(pugi::xml_node& elem);
 
-    virtual bool parseComponent(const pugi::xml_node& elem);
+    virtual bool parseComponent(const pugi::xml_node& elem, const pugi::xml_node& addressable);
     virtual bool parseRegister(const pugi::xml_node& elem, Component& component, bool update = false);
+    bool parseRegisterChild(const pugi::xml_node& current, Tag tag, Register& reg, bool update, bool hasID);
     virtual bool parseRegisterBitmap(const pugi::xml_node& elem, Register& reg, bool update = false);
     virtual bool parseEnumerations(const pugi::xml_node& elem, RegisterBitmap& bitmap, bool update = false);
     virtual bool parsseEnumeration(const pugi::xml_node& elem, RegisterBitmap& bitmap, bool update = false);
 
-    virtual RegisterBitmap::Type registerType(const std::string& type) const;
+    virtual RegisterBitmap::Type registerType(const char* type) const;
 
 private:
     int mAddressUnitBits;
+    std::string mFilename;
+
+    // Backs the documents, reset after each streamed address block.
+    XMLArena mArena;
 };
 
 #endif /* !IPXACTREADER_H */
@@ -55,20 +55,21 @@ public:
     IPXACTWriter(const char* filename);
     ~IPXACTWriter();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
+    virtual bool usesCompiledModelOnly() const { return true; }
 
 protected:
-    virtual void serialize_bitmap_definition(pugi::xml_node& elem, RegisterBitmap& bitmap, int regwidth);
-    virtual void serialize_bitmap_declaration(pugi::xml_node& elem, RegisterBitmap& bitmap, int regwidth);
+    virtual void serialize_bitmap_definition(pugi::xml_node& elem, const CompiledModel& model, size_t bitmap, int regwidth);
+    virtual void serialize_bitmap_declaration(pugi::xml_node& elem, const CompiledModel& model, size_t bitmap, int regwidth);
 
-    virtual void serialize_register_definition(pugi::xml_node& elem, Register& reg);
-    virtual void serialize_register_declaration(pugi::xml_node& elem, Register& reg);
+    virtual void serialize_register_definition(pugi::xml_node& elem, const CompiledModel& model, size_t reg);
+    virtual void serialize_register_declaration(pugi::xml_node& elem, const CompiledModel& model, size_t reg);
 
-    virtual void serialize_component_declaration(pugi::xml_node& elem, Component& component);
+    virtual void serialize_component_declaration(pugi::xml_node& elem, const CompiledModel& model, size_t component);
 
 
     pugi::xml_node insertElement(pugi::xml_node& elem, const std::string& name, const std::string& value);
-    pugi::xml_node insertElement(pugi::xml_node& elem, const std::string& name, unsigned int value);
+    pugi::xml_node insertElement(pugi::xml_node& elem, const std::string& name, uint64_t value);
     pugi::xml_node insertElement(pugi::xml_node& elem, const std::string& name);
 
     std::string registerType(RegisterBitmap::Type type) const;
@@ -58,7 +58,7 @@ public:
     LaTeXWriter(const char* filename);
     ~LaTeXWriter();
 
-    virtual bool write(Components& components);
+    virtual bool write(const CompiledModel& model);
 
 protected:
     virtual std::string serialize_bitmap_definition(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth);
@@ -81,7 +81,6 @@ private:
     int mIndent;
     char* mFilename;
 
-    void strreplace(std::string& origstr, const std::string& find, const std::string& replace);
 };
 
 #endif /* !LATEXWRITER_H */
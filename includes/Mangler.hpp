@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/Mangler.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Identifier mangling shared by the writers.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MANGLER_HPP
+#define MANGLER_HPP
+
+#include <string>
+
+// Turns model names into identifiers or document text. Every style is one
+// pass over a per-byte table, and results are kept per style so a name
+// used by several declarations or writers is only mangled once.
+class Mangler
+{
+public:
+    enum Style {
+        Identifier,     // C identifier, '@' and '/' spelled out.
+        Enumerator,     // Identifier without spaces.
+        Assembler,      // Identifier keeping '-' for assembler symbols.
+        CamelCase,      // Separators dropped, words capitalized.
+        Capitalized,    // Only '_' separates words.
+        LaTeX,          // '_' and '$' escaped.
+        StyleCount
+    };
+
+    // Thread safe, the reference stays valid for the whole run.
+    static const std::string& get(const std::string& name, Style style);
+
+    static std::string mangle(const std::string& name, Style style);
+};
+
+#endif /* !MANGLER_HPP */
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/ModelCache.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Binary cache of the parsed register model.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MODELCACHE_HPP
+#define MODELCACHE_HPP
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+class Components;
+
+// Stores the model read from a set of input files so later runs over the
+// same inputs can skip the readers. Cache files are named after a hash of
+// the reader options and the contents of every input, so any change to an
+// input selects a different file.
+class ModelCache
+{
+public:
+    ModelCache(const std::string& directory);
+    ~ModelCache();
+
+    // Hash the inputs, returns false if an input can't be read. Components
+    // lists the names read with --component, empty when reading everything.
+    // Descriptions is false when the readers skipped descriptions.
+    bool computeKey(const std::vector<std::string>& inputs, bool mergeAddr, bool descriptions,
+                    const std::vector<std::string>& components);
+
+    // Populate an empty components list from the cache file, returns false
+    // on a miss or a stale or damaged file.
+    bool load(Components& components);
+
+    // Write the model to the cache file.
+    bool save(Components& components);
+
+    const std::string& getPath() const { return mPath; }
+
+private:
+    std::string mDirectory;
+    std::string mPath;
+    uint64_t    mKey;
+};
+
+#endif /* !MODELCACHE_HPP */
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/NameIndex.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Open addressing name to element index.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NAMEINDEX_HPP
+#define NAMEINDEX_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include <StringPool.hpp>
+
+// Keys are interned, so probing compares symbols instead of strings.
+template <class T> class NameIndex {
+public:
+    NameIndex() : mUsed(0) { }
+
+    T* find(const std::string& name) const
+    {
+        Symbol symbol;
+        if(mSlots.empty() || !StringPool::global().find(name, symbol))
+        {
+            return NULL;
+        }
+
+        return find(symbol);
+    }
+
+    T* find(const Symbol& name) const
+    {
+        if(mSlots.empty())
+        {
+            return NULL;
+        }
+
+        size_t mask = mSlots.size() - 1;
+        for(size_t i = name.hash() & mask; mSlots[i].used; i = (i + 1) & mask)
+        {
+            const Slot& slot = mSlots[i];
+            if(slot.name == name)
+            {
+                return slot.element;
+            }
+        }
+
+        return NULL;
+    }
+
+    void insert(const std::string& name, T* element)
+    {
+        insert(StringPool::global().intern(name), element);
+    }
+
+    // Add or replace the element stored under name. Entries are never
+    // removed, a removed element is stored as NULL instead.
+    void insert(const Symbol& name, T* element)
+    {
+        // Keep the load factor below 3/4 so probe sequences stay short.
+        if((mUsed + 1) * 4 > mSlots.size() * 3)
+        {
+            grow();
+        }
+
+        size_t mask = mSlots.size() - 1;
+        size_t i = name.hash() & mask;
+        for(; mSlots[i].used; i = (i + 1) & mask)
+        {
+            Slot& slot = mSlots[i];
+            if(slot.name == name)
+            {
+                slot.element = element;
+                return;
+            }
+        }
+
+        Slot& slot = mSlots[i];
+        slot.name = name;
+        slot.element = element;
+        slot.used = true;
+        mUsed++;
+    }
+
+    void clear()
+    {
+        mSlots.clear();
+        mUsed = 0;
+    }
+
+    size_t size() const { return mUsed; }
+
+private:
+    struct Slot {
+        Slot() : element(NULL), used(false) { }
+
+        Symbol      name;
+        T*          element;
+        bool        used;
+    };
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(mSlots);
+
+        mSlots.resize(old.empty() ? 16 : old.size() * 2);
+        size_t mask = mSlots.size() - 1;
+
+        for(size_t j = 0; j < old.size(); j++)
+        {
+            if(old[j].used)
+            {
+                size_t i = old[j].name.hash() & mask;
+                while(mSlots[i].used)
+                {
+                    i = (i + 1) & mask;
+                }
+                mSlots[i] = old[j];
+            }
+        }
+    }
+
+    std::vector<Slot>   mSlots;
+    size_t              mUsed;
+};
+
+#endif /* !NAMEINDEX_HPP */
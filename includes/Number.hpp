@@ -45,20 +45,60 @@
 #ifndef NUMBER_HPP
 #define NUMBER_HPP
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
+#include <vector>
 
 class Number {
 public:
+	Number(const char* numstring);
+	Number(const char* numstring, size_t length);
 	Number(const std::string& numstring);
 
 	bool isValid() const { return mValid; };
 	unsigned int getWidth() const { return mWidth; };
-	unsigned int getValue() const { return mValue; };
+
+	/// Number of 64bit words needed to hold the value.
+	unsigned int getWords() const { return 1 + mWideValue.size(); };
+
+	uint64_t getValue(unsigned int word = 0) const { return get(mValue, mWideValue, word); };
+
+	/// Bits given as x (unknown) or z / ? (high impedance) digits.
+	uint64_t getXMask(unsigned int word = 0) const { return get(mXMask, mWideXMask, word); };
+	uint64_t getZMask(unsigned int word = 0) const { return get(mZMask, mWideZMask, word); };
+	bool hasUnknown() const;
+
+	/// Set when a sized literal had bits beyond its declared width.
+	bool isTruncated() const { return mTruncated; };
 
 private:
+	void parse(const char* begin, const char* end);
+	bool parseVerilog(const char* begin, const char* end);
+	void parseNumber(const char* begin, const char* end);
+
+	void resize(unsigned int words);
+	void setBits(unsigned int bit, unsigned int count, uint64_t value, uint64_t& word0, std::vector<uint64_t>& wide);
+	void multiplyAdd(unsigned int factor, unsigned int addend);
+	void truncate(unsigned int width);
+
+	static uint64_t get(uint64_t word0, const std::vector<uint64_t>& wide, unsigned int word)
+	{
+		return word ? (word <= wide.size() ? wide[word - 1] : 0) : word0;
+	}
+
 	bool mValid;
+	bool mTruncated;
 	unsigned int  mWidth;
-	unsigned int  mValue;
+
+	// Word 0 is kept inline, only literals wider than 64 bits use the vectors.
+	uint64_t      mValue;
+	uint64_t      mXMask;
+	uint64_t      mZMask;
+	std::vector<uint64_t> mWideValue;
+	std::vector<uint64_t> mWideXMask;
+	std::vector<uint64_t> mWideZMask;
 };
 
 #endif /* !NUMBER_HPP */
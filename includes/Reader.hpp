@@ -45,8 +45,9 @@
 #ifndef READER_H
 #define READER_H
 
+#include <stddef.h>
+
 #include <iostream>
-#include <fstream>
 #include <map>
 #include <string>
 
@@ -60,14 +61,42 @@ public:
     virtual ~Reader();
 
     virtual bool is_open() {
-        return mFile.is_open();
+        return mFD >= 0;
     }
 
     virtual bool read() = 0;
 
+    // Set before reading when the output has no use for descriptions, the
+    // readers then skip them instead of copying them into the model.
+    static void setDescriptions(bool descriptions);
+
 protected:
-    std::ifstream mFile;
+    static bool sDescriptions;
+
+    // Maps the input as a private, writable copy-on-write buffer so the
+    // whole document can be parsed in place. Only the pages pugixml writes
+    // to are copied, the file is never modified. The mapping lives until
+    // the reader is destroyed.
+    char* mapFile(size_t& size);
+
+    // Maps the input read only and unmodified, for readers that only look
+    // at part of the file at a time. Use either this or mapFile.
+    const char* viewFile(size_t& size);
+
+    // Element or attribute text with line breaks removed, matching the
+    // previous line based loading.
+    static std::string text(const char* value);
+
+    // Allows the kernel to drop mapped pages before offset.
+    void releaseFile(size_t offset);
+
+    int mFD;
+    char* mData;
+    size_t mSize;
     Components& mComponents;
+
+private:
+    bool map(int protection);
 };
 
 class ReaderFactory
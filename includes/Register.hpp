@@ -45,50 +45,87 @@
 #ifndef REGISTER_HPP
 #define REGISTER_HPP
 
-#include <map>
-#include <list>
+#include <stdint.h>
+
+#include <algorithm>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <Arena.hpp>
+#include <StringPool.hpp>
+#include <NameIndex.hpp>
+#include <AddressIndex.hpp>
 
 template <class T> class Container {
 public:
     Container(const std::string& name) {
-        mName = name;
-        mDescription = "";
+        mName = StringPool::global().intern(name);
+        mSorted = true;
+        mDeclarationCount = 0;
     }
 
     Container(const std::string& name, const std::string& desc) {
-        mName = name;
-        mDescription = desc;
+        mName = StringPool::global().intern(name);
+        mDescription = StringPool::global().intern(desc);
+        mSorted = true;
+        mDeclarationCount = 0;
     }
     ~Container() {
         clear();
     };
 
-    const std::string& getName() const { return mName; };
-    const std::string& getDescription() const { return mDescription; };
+    const std::string& getName() const { return mName.str(); };
+    const std::string& getDescription() const { return mDescription.str(); };
+
+    // Interned names, equal symbols have equal strings.
+    const Symbol& getNameSymbol() const { return mName; };
+    const Symbol& getTypeIDSymbol() const { return mTypeID; };
+    const Symbol& getDescriptionSymbol() const { return mDescription; };
 
-    void setDescription(const std::string& desc) { mDescription = desc; };
-    void setName(const std::string& name) { mName = name; };
+    void setDescription(const std::string& desc) { mDescription = StringPool::global().intern(desc); };
+    void setName(const std::string& name) { mName = StringPool::global().intern(name); };
 
 
-    virtual const std::list<T*>& get() {
+    // Elements are appended unsorted, the list is only sorted once before
+    // the first ordered access after an insertion.
+    virtual const std::vector<T*>& get() {
+        if(!mSorted)
+        {
+            sort();
+            mSorted = true;
+        }
+        return mList;
+    }
+
+    // Read only access, the list is returned as last sorted.
+    const std::vector<T*>& get() const {
         return mList;
     }
 
     virtual T* get(const std::string& name) {
-        return mMap[name];
+        return mIndex.find(name);
+    }
+
+    T* get(const Symbol& name) {
+        return mIndex.find(name);
     }
 
     virtual void set(const std::string& name, T* element) {
-        mMap[name] = element;
+        if(element && mIndex.find(name) == element)
+        {
+            // Already stored under this name.
+            return;
+        }
+
+        mIndex.insert(name, element);
         mList.push_back(element);
-        sort();
+        mSorted = false;
     }
 
     virtual void setTypeID(const std::string& type, const std::string &copy) {
-        mTypeID = type;
-        mTypeIDCopy = copy;
+        mTypeID = StringPool::global().intern(type);
+        mTypeIDCopy = StringPool::global().intern(copy);
     }
 
     virtual T* getElementWithTypeID(std::string &typeID) {
@@ -96,11 +133,11 @@ public:
     }
 
     virtual const std::string& getTypeID(void) {
-        return mTypeID;
+        return mTypeID.str();
     }
 
     virtual const std::string& getTypeIDCopy(void) {
-        return mTypeIDCopy;
+        return mTypeIDCopy.str();
     }
 
     virtual bool isTypeIDCopy(void) {
@@ -118,8 +155,8 @@ public:
 
     virtual void remove(const std::string& name, T* element)
     {
-        mList.remove(element);
-        mMap[name] = NULL;
+        mList.erase(std::remove(mList.begin(), mList.end(), element), mList.end());
+        mIndex.insert(name, NULL);
     }
 
 
@@ -128,28 +165,160 @@ public:
     }
 
 
+    // Elements are owned by the Components arena, only the references are
+    // dropped here.
     virtual void clear() {
-        for(typename std::list<T*>::const_iterator it = mList.begin();
-            it != mList.end(); ++it)
+        mList.clear();
+        mIndex.clear();
+        mTypeIndex.clear();
+        mDeclarations.clear();
+        mDeclaredType.clear();
+        mSorted = true;
+    }
+
+
+    virtual void sort() = 0;
+
+protected:
+    // Stable sort, skipped when the list is already in order.
+    // Returns true when the order changed.
+    template <class Compare> bool sortList(Compare compare) {
+        if(std::is_sorted(mList.begin(), mList.end(), compare))
         {
-            // delete *it;
+            return false;
         }
 
-        // mList.clear();
-        // mMap.clear();
+        std::stable_sort(mList.begin(), mList.end(), compare);
+        return true;
     }
 
+    // First element declaring the given typeIdentifier.
+    T* findTypeID(const std::string& name) {
+        Symbol typeID;
+        if(name.empty() || !StringPool::global().find(name, typeID))
+        {
+            return NULL;
+        }
 
-    virtual void sort() = 0;
+        return findTypeID(typeID);
+    }
 
-protected:
-    std::string mName;
-    std::string mTypeID;
-    std::string mTypeIDCopy;
-    std::string mDescription;
+    T* findTypeID(const Symbol& typeID) {
+        T* element = mTypeIndex.find(typeID);
+        if(element && element->getTypeIDSymbol() != typeID)
+        {
+            // Element was retyped after being indexed, look for another.
+            element = firstDeclared(typeID);
+            mTypeIndex.insert(typeID, element);
+        }
+
+        return element;
+    }
+
+    void indexTypeID(T* element) {
+        const Symbol& typeID = element->getTypeIDSymbol();
+        typename DeclaredTypes::iterator declared = mDeclaredType.find(element);
+        if(declared != mDeclaredType.end() && declared->second.first == typeID)
+        {
+            // Already declared, keep its place.
+            return;
+        }
+
+        if(typeID.empty())
+        {
+            if(declared != mDeclaredType.end())
+            {
+                mDeclaredType.erase(declared);
+            }
+            return;
+        }
+
+        // Any entry under a previous typeIdentifier is left behind and
+        // skipped by firstDeclared.
+        size_t number = mDeclarationCount++;
+        mDeclaredType[element] = std::make_pair(typeID, number);
+        mDeclarations[typeID].elements.push_back(std::make_pair(element, number));
+
+        if(!findTypeID(typeID))
+        {
+            mTypeIndex.insert(typeID, element);
+        }
+    }
+
+    void unindexTypeID(T* element) {
+        const Symbol& typeID = element->getTypeIDSymbol();
+        mDeclaredType.erase(element);
+        if(!typeID.empty() && mTypeIndex.find(typeID) == element)
+        {
+            // Hand the type over to the next element declaring it, if any.
+            mTypeIndex.insert(typeID, firstDeclared(typeID));
+        }
+    }
+
+private:
+    // Elements declaring one typeIdentifier, in declaration order. Entries
+    // before first and entries whose number no longer matches mDeclaredType
+    // belong to elements since retyped or removed.
+    struct Declarations {
+        Declarations() : first(0) { }
+
+        std::vector<std::pair<T*, size_t> > elements;
+        size_t first;
+    };
+
+    typedef std::unordered_map<Symbol, Declarations, Symbol::Hash> TypeDeclarations;
+
+    // typeIdentifier and declaration number of every typed element.
+    typedef std::unordered_map<T*, std::pair<Symbol, size_t> > DeclaredTypes;
+
+    // Earliest element still declaring typeID. The list is sorted by name
+    // or address, so declaration order is kept separately.
+    T* firstDeclared(const Symbol& typeID) {
+        typename TypeDeclarations::iterator it = mDeclarations.find(typeID);
+        if(it == mDeclarations.end())
+        {
+            return NULL;
+        }
+
+        Declarations& declarations = it->second;
+        for(size_t i = declarations.first; i < declarations.elements.size(); i++)
+        {
+            T* element = declarations.elements[i].first;
+            typename DeclaredTypes::const_iterator declared = mDeclaredType.find(element);
+            if(declared == mDeclaredType.end() || declared->second.second != declarations.elements[i].second)
+            {
+                // Stale, never valid again. Drop it when it is in front.
+                if(i == declarations.first) declarations.first++;
+                continue;
+            }
+
+            if(element->getTypeIDSymbol() == typeID)
+            {
+                return element;
+            }
+        }
+
+        if(declarations.first == declarations.elements.size())
+        {
+            mDeclarations.erase(it);
+        }
+
+        return NULL;
+    }
 
-    std::map<std::string, T*>   mMap;
-    std::list<T*>               mList;
+protected:
+    Symbol mName;
+    Symbol mTypeID;
+    Symbol mTypeIDCopy;
+    Symbol mDescription;
+
+    NameIndex<T>        mIndex;
+    NameIndex<T>        mTypeIndex;
+    TypeDeclarations    mDeclarations;
+    DeclaredTypes       mDeclaredType;
+    size_t              mDeclarationCount;
+    std::vector<T*>     mList;
+    bool                mSorted;
 };
 
 class Enumeration : public Container<int>
@@ -158,15 +327,18 @@ public:
     Enumeration(const std::string& name);
     virtual ~Enumeration() { }
 
-    unsigned int getValue() const { return mValue; };
-    void setValue(unsigned int value) { mValue = value; };
+    uint64_t getValue() const { return mValue; };
+    void setValue(uint64_t value) { mValue = value; };
 
     virtual void sort();
 
 private:
-    unsigned int mValue;
+    uint64_t mValue;
 };
 
+class Component;
+class Register;
+
 class RegisterBitmap : public Container<Enumeration>
 {
 public:
@@ -188,15 +360,25 @@ public:
     int getStop() const { return mStopBit; };
     RegisterBitmap::Type getType() const { return mType; };
 
-    unsigned int getMask() const;
+    // Mask of the field's bits within the first 64 bits of the register.
+    uint64_t getMask() const { return mMask; };
+
+    // Mask of the field's bits within 64bit word 'word' of the register.
+    uint64_t getMask(unsigned int word) const;
+
+    // Mask of the field's value, not shifted into position.
+    uint64_t getFieldMask() const;
 
-    void setStart(int start) { mStartBit = start; };
-    void setStop(int stop) { mStopBit = stop; };
-    void setType(RegisterBitmap::Type type) { mType = type; };
+    void setStart(int start);
+    void setStop(int stop);
+    void setType(RegisterBitmap::Type type);
     int getWidth() const { return mStartBit - mStopBit; };
 
-    void setResetValue(unsigned int resetValue);
-    unsigned int getResetValue() const { return mResetValue; }
+    // Reset bits given as x or z are recorded in the unknown mask, their
+    // bits in the reset value are zero.
+    void setResetValue(uint64_t resetValue, uint64_t unknownMask = 0);
+    uint64_t getResetValue() const { return mResetValue; }
+    uint64_t getResetUnknownMask() const { return mResetUnknownMask; }
     bool hasResetValue() const { return mHasResetValue; }
 
     void setReserved(bool reserved);
@@ -207,20 +389,34 @@ public:
 
     virtual void sort();
 
+    // Registers holding this bitmap, notified when the bits, type or reset
+    // value change.
+    void addOwner(Register* reg);
+    void removeOwner(Register* reg);
+
 private:
+    void updateMask();
+    void changed();
+
     int mStartBit;
     int mStopBit;
+    uint64_t mMask;
 
     int mDefault;
     RegisterBitmap::Type mType;
 
     bool mHasResetValue;
-    unsigned int mResetValue;
+    uint64_t mResetValue;
+    uint64_t mResetUnknownMask;
 
     bool mReserved;
     bool mConstantValue;
+
+    std::vector<Register*> mOwners;
 };
 
+class Components;
+
 class Register : public Container<RegisterBitmap>
 {
 public:
@@ -236,19 +432,75 @@ public:
     void setDimensions(unsigned int dim);
     unsigned int getDimensions(void) const { return mDimensions; };
 
-    unsigned int getResetValue(void) const;
-    unsigned int getWriteMask(void) const;
-    unsigned int getMask(void) const;
+    // Aggregates over all fields. Registers wider than 64 bits are split
+    // into 64bit words, word 0 holding the least significant bits.
+    unsigned int getWords(void) const;
+
+    uint64_t getResetValue(unsigned int word = 0) const;
+    uint64_t getResetUnknownMask(unsigned int word = 0) const;
+    uint64_t getWriteMask(unsigned int word = 0) const;
+    uint64_t getMask(unsigned int word = 0) const;
 
-    bool hasReadOnly() const;
-    bool hasWriteOnly() const;
-    bool hasWrite() const;
+    bool hasReadOnly() const { return accessFlags() & HasReadOnly; }
+    bool hasWriteOnly() const { return accessFlags() & HasWriteOnly; }
+    bool hasWrite() const { return accessFlags() & HasWrite; }
 
     virtual void sort();
+
+    virtual const std::vector<RegisterBitmap*>& get() {
+        return Container<RegisterBitmap>::get();
+    }
+    virtual RegisterBitmap* get(const std::string& name) {
+        return Container<RegisterBitmap>::get(name);
+    }
+
+    virtual void set(const std::string& name, RegisterBitmap* element);
+    virtual void remove(const std::string& name, RegisterBitmap* element);
+    virtual void clear();
+
+    // Drop the cached masks after a bitmap was modified.
+    void updateBitmap(RegisterBitmap* bitmap);
+
+    virtual void setTypeID(const std::string& type, const std::string &copy);
+
+    // Components holding this register, notified when the address or type
+    // changes.
+    void addOwner(Component* component);
+    void removeOwner(Component* component);
+
+    // Component that defined this register. Typed copies hold the same
+    // register without being its parent.
+    Component* getParent() const { return mParent; }
+    void setParent(Component* component) { mParent = component; }
+
 private:
+    enum AccessFlags {
+        HasReadOnly     = 1 << 0,
+        HasWriteOnly    = 1 << 1,
+        HasWrite        = 1 << 2,
+    };
+
+    unsigned int accessFlags() const {
+        if(!mCacheValid) updateCache();
+        return mAccessFlags;
+    }
+
+    // Aggregates over all bitmaps, computed in one pass on first use.
+    void updateCache() const;
+
     uint64_t mAddress;
     int mWidth;
     int mDimensions;
+
+    mutable bool mCacheValid;
+    mutable std::vector<uint64_t> mResetValue;
+    mutable std::vector<uint64_t> mResetUnknownMask;
+    mutable std::vector<uint64_t> mWriteMask;
+    mutable std::vector<uint64_t> mMask;
+    mutable unsigned int mAccessFlags;
+
+    Component* mParent;
+    std::vector<Component*> mOwners;
 };
 
 class Component : public Container<Register>
@@ -274,16 +526,44 @@ public:
 
     Register* getElementWithTypeID(std::string &typeID);
 
+    // True when a register is owned by another component, as in typed
+    // copies.
+    bool sharesRegisters();
+
     virtual Register* get(uint64_t address);
 
-    virtual const std::list<Register*>& get() {
+    virtual const std::vector<Register*>& get() {
         return Container<Register>::get();
     }
     virtual Register* get(const std::string& name) {
         return Container<Register>::get(name);
     }
+    Register* get(const Symbol& name) {
+        return Container<Register>::get(name);
+    }
+
+    virtual void set(const std::string& name, Register* element);
+    virtual void remove(const std::string& name, Register* element);
+    virtual void clear();
+
+    virtual void setTypeID(const std::string& type, const std::string &copy);
+
+    void updateAddress(Register* reg, uint64_t oldAddr);
+    void updateTypeID(Register* reg);
+
+    // Components lists holding this component, notified when the type
+    // changes.
+    void addOwner(Components* components);
+    void removeOwner(Components* components);
+
+    std::vector<std::pair<Register*, Register*> > getOverlaps() const {
+        return mAddresses.getOverlaps(mAddressUnitBits);
+    }
 
 private:
+    AddressIndex mAddresses;
+    std::vector<Components*> mOwners;
+
     uint64_t mBase;
     std::string mModuleName;
     int mRange;
@@ -302,8 +582,49 @@ public:
 
     Component* getElementWithTypeID(std::string &typeID);
 
+    virtual void set(const std::string& name, Component* element);
+    virtual void remove(const std::string& name, Component* element);
+
+    void updateTypeID(Component* component);
+
+    // Allocate a model element owned by this list. Elements live until the
+    // list is released or destroyed.
+    template <class T, class... Args> T* create(Args&&... args) {
+        return pool<T>().create(std::forward<Args>(args)...);
+    }
+
+    // Drop all components and free every element created by this list.
+    void release();
+
+    // Appends every component of 'other', in its order, and takes ownership
+    // of it. Its elements stay in its pools until this list is released.
+    void adopt(Components* other);
+
+    // Deep copy of a register, its fields and enumerations.
+    Register* clone(Register& reg);
+
+    // Register of 'component' that may be modified without affecting other
+    // components. Once one register is modified the component is no longer
+    // identical to its typed copy's source, so every register it shares is
+    // cloned and the component drops its typeIdentifier.
+    Register* unshare(Component& component, Register* reg);
+    void unshare(Component& component);
+
 private:
+    template <class T> ArenaPool<T>& pool();
+
+    ArenaPool<Component>        mComponentPool;
+    ArenaPool<Register>         mRegisterPool;
+    ArenaPool<RegisterBitmap>   mBitmapPool;
+    ArenaPool<Enumeration>      mEnumerationPool;
+
+    std::vector<Components*>    mAdopted;
 };
 
+template <> inline ArenaPool<Component>& Components::pool<Component>() { return mComponentPool; }
+template <> inline ArenaPool<Register>& Components::pool<Register>() { return mRegisterPool; }
+template <> inline ArenaPool<RegisterBitmap>& Components::pool<RegisterBitmap>() { return mBitmapPool; }
+template <> inline ArenaPool<Enumeration>& Components::pool<Enumeration>() { return mEnumerationPool; }
+
 
 #endif /* !REGISTER_HPP */
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/StringPool.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Interned string symbols.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <stdint.h>
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+
+// Handle to a string stored once in the StringPool. Two symbols are equal
+// exactly when their strings are equal.
+class Symbol {
+public:
+    Symbol() : mString(&emptyString()) { }
+
+    const std::string& str() const { return *mString; }
+    bool empty() const { return mString->empty(); }
+
+    bool operator==(const Symbol& other) const { return mString == other.mString; }
+    bool operator!=(const Symbol& other) const { return mString != other.mString; }
+
+    uint64_t hash() const
+    {
+        uint64_t hash = (uintptr_t)mString;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // For unordered containers keyed by symbol.
+    struct Hash {
+        size_t operator()(const Symbol& symbol) const { return symbol.hash(); }
+    };
+
+private:
+    friend class StringPool;
+    explicit Symbol(const std::string* string) : mString(string) { }
+
+    static const std::string& emptyString()
+    {
+        static const std::string empty;
+        return empty;
+    }
+
+    const std::string* mString;
+};
+
+// Strings are looked up far more often than added, lookups and interning
+// an existing string only take the lock shared.
+class StringPool {
+public:
+    // Pool shared by all model elements.
+    static StringPool& global();
+
+    Symbol intern(const std::string& string);
+
+    // Symbol for an already interned string, returns false when the string
+    // was never interned.
+    bool find(const std::string& string, Symbol& symbol) const;
+
+    size_t size() const;
+
+private:
+    StringPool();
+    StringPool(const StringPool&);
+    StringPool& operator=(const StringPool&);
+
+    // Node based, so references stay valid when the table grows.
+    std::unordered_set<std::string> mStrings;
+    mutable std::shared_timed_mutex mLock;
+};
+
+#endif /* !STRINGPOOL_HPP */
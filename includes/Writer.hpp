@@ -46,9 +46,12 @@
 #define WRITER_H
 
 #include <iostream>
-#include <fstream>
+#include <sstream>
 
 #include <Register.hpp>
+#include <CompiledModel.hpp>
+#include <Template.hpp>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -58,24 +61,46 @@ public:
     Writer(const char* filename);
     virtual ~Writer();
 
-    virtual bool write(Components& components) = 0;
+    virtual bool write(const CompiledModel& model) = 0;
 
-    virtual bool is_open() {
-        return mFile.is_open();
+    // True when the output file can be created or replaced.
+    virtual bool is_open();
+
+    // Writes mFile to the output file, unless it already has that content.
+    bool commit();
+
+    // True when write() only reads the compiled arrays, so it can run
+    // alongside other writers.
+    virtual bool usesCompiledModelOnly() const {
+        return false;
     }
 
-    void UpdateTemplate(std::string& contents, std::string& filename, Component &component);
-    void UpdateTemplate(std::string& contents, std::string& filename);
+    // Sets the values shared by every resource template.
+    void FillTemplate(Template::Values& values, const std::string& filename, Component &component);
+    void FillTemplate(Template::Values& values, const std::string& filename);
     bool WriteToFile(std::string& filename, std::string& contents);
 
 protected:
-    std::ofstream mFile;
+    // No output file, used for the writer of a single component.
+    Writer();
+
+    // Calls write for every component, see --jobs.
+    bool writeComponents(const Components& components, const std::function<bool(Component&)>& write);
+
+    // Contents of the output file, written by commit().
+    std::ostringstream mFile;
+
+private:
+    std::string mOutputFile;
 };
 
 class WriterFactory
 {
 public:
     static Writer* create(const char* filename, const char* force_extension);
+
+    // False when the writer never prints register or field descriptions.
+    static bool usesDescriptions(const char* filename, const char* force_extension);
 };
 
 
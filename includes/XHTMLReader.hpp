@@ -45,10 +45,13 @@
 #ifndef XHTMLREADER_H
 #define XHTMLREADER_H
 
+#include <Diagnostics.hpp>
 #include <Reader.hpp>
+#include <XMLArena.hpp>
 
 #include <pugixml.hpp>
 #include <string>
+#include <vector>
 
 class XHTMLReader : public Reader
 {
@@ -60,15 +63,29 @@ public:
     virtual bool read();
 
 private:
-    virtual bool parseElement(const pugi::xml_node& elem);
+    struct Section {
+        pugi::xml_node node;
+        std::string id;
+        Components* components;
+        DiagnosticsCapture messages;
+        bool status;
+    };
 
-    virtual bool addComponent(const pugi::xml_node& elem, std::string &id);
-    virtual bool addRegister(const pugi::xml_node& elem, Component &component, int width);
-    virtual bool addBitmap(const pugi::xml_node& elem, Register &reg);
-    virtual bool addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bitmap);
+    virtual void parseElement(const pugi::xml_node& elem);
+    bool parseSections();
+
+    // Elements are added to components.
+    virtual bool addComponent(const pugi::xml_node& elem, std::string &id, Components& components);
+    virtual bool addRegister(const pugi::xml_node& elem, Component &component, int width, Components& components);
+    virtual bool addBitmap(const pugi::xml_node& elem, Register &reg, Components& components);
+    virtual bool addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bitmap, Components& components);
 
 private:
     int mAddressUnitBits;
+
+    XMLArena mArena;
+
+    std::vector<Section> mSections;
 };
 
 #endif /* !XHTMLREADER_H */
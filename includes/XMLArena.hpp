@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/XMLArena.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Arena allocator for pugixml documents.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef XMLARENA_HPP
+#define XMLARENA_HPP
+
+#include <stddef.h>
+
+#include <vector>
+
+// Bump allocator for the documents built by a reader. While a Scope is
+// open, pugixml allocations made by that thread come from the arena and
+// are freed together with reset() or when the arena is destroyed, instead
+// of one page at a time. Documents must not outlive the arena.
+class XMLArena
+{
+public:
+    XMLArena();
+    ~XMLArena();
+
+    class Scope
+    {
+    public:
+        Scope(XMLArena& arena);
+        ~Scope();
+
+    private:
+        XMLArena* mPrevious;
+    };
+
+    // Drops every allocation, the largest chunk is kept for reuse.
+    void reset();
+
+    // Installs the pugixml memory hooks. Call before any document exists.
+    static void install();
+
+private:
+    XMLArena(const XMLArena&);
+    XMLArena& operator=(const XMLArena&);
+
+    void* allocate(size_t size);
+
+    static void* pugiAllocate(size_t size);
+    static void pugiDeallocate(void* ptr);
+
+    std::vector<char*> mChunks;
+    size_t mChunkSize;
+    size_t mUsed;
+};
+
+#endif /* !XMLARENA_HPP */
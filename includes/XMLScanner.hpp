@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       includes/XMLScanner.hpp
+///
+/// @project    ipxact
+///
+/// @brief      Minimal forward only XML tag scanner.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef XMLSCANNER_HPP
+#define XMLSCANNER_HPP
+
+#include <stddef.h>
+#include <string.h>
+
+// Walks the tags of an XML buffer without building a tree. Text, comments,
+// processing instructions, CDATA and DOCTYPE declarations are skipped. The
+// buffer is never modified.
+class XMLScanner
+{
+public:
+    enum Token {
+        End,
+        StartTag,
+        EmptyTag,
+        EndTag,
+        Error,
+    };
+
+    XMLScanner(const char* begin, const char* end);
+
+    Token next();
+
+    // Moves past the end tag matching the last StartTag.
+    bool skipElement();
+
+    bool isName(const char* name) const {
+        return strlen(name) == mNameLength && !memcmp(name, mName, mNameLength);
+    }
+    const char* getName() const { return mName; }
+    size_t getNameLength() const { return mNameLength; }
+
+    // First byte of the last tag and the byte following it.
+    const char* getTagBegin() const { return mTag; }
+    const char* getPosition() const { return mPos; }
+
+private:
+    bool skipPast(const char* from, const char* terminator);
+
+    const char* mPos;
+    const char* mEnd;
+    const char* mTag;
+    const char* mName;
+    size_t mNameLength;
+};
+
+#endif /* !XMLSCANNER_HPP */
@@ -47,15 +47,23 @@
 #include <unistd.h>
 #include <getopt.h>
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <list>
 #include <map>
+#include <set>
 #include <string>
+#include <thread>
 
 #include <OptionParser.h>
+#include <Diagnostics.hpp>
 #include <Register.hpp>
 #include <Writer.hpp>
 #include <Reader.hpp>
+#include <ModelCache.hpp>
+#include <OutputFile.hpp>
+#include <XMLArena.hpp>
 
 using namespace std;
 using namespace optparse;
@@ -63,8 +71,250 @@ using namespace optparse;
 Components gComponents;
 Values* gOptions;
 
+static bool readFile(const char* filename, Components& components)
+{
+    Diagnostics::status("Reading file: %s", filename);
+
+    bool status = true;
+    Reader* myReader = ReaderFactory::open(filename, components);
+    if(myReader && myReader->is_open())
+    {
+        if(!myReader->read())
+        {
+            Diagnostics::error("Reader failed to read file: %s", filename);
+            status = false;
+        }
+    }
+    else
+    {
+        Diagnostics::error("Unable to open input file '%s' for reading", filename);
+        status = false;
+    }
+    delete myReader;
+
+    return status;
+}
+
+// A file read on its own gives the same model as a serial read when none of
+// its components or component types were already defined by earlier files.
+static bool isIndependent(Components& components, Components& file)
+{
+    const vector<Component*>& list = file.get();
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        if(!list[i])
+        {
+            continue;
+        }
+
+        string typeID = list[i]->getTypeID();
+        if(components.get(list[i]->getNameSymbol()) ||
+           (!typeID.empty() && components.getElementWithTypeID(typeID)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Reads all files concurrently into private lists, then merges them in
+// command line order. Files depending on earlier ones are read again into
+// the shared list so the result matches a serial read. Messages are held
+// per file and printed in the same order.
+static bool readFiles(const vector<string>& filenames, Components& components, unsigned int jobs)
+{
+    vector<Components*> files(filenames.size());
+    vector<char> status(filenames.size());
+    vector<DiagnosticsCapture> messages(filenames.size());
+    atomic<size_t> next(0);
+
+    vector<thread> workers;
+    for(unsigned int i = 0; i < jobs && i < filenames.size(); i++)
+    {
+        workers.push_back(thread([&]() {
+            size_t index;
+            while((index = next++) < filenames.size())
+            {
+                files[index] = new Components();
+                messages[index].start();
+                status[index] = readFile(filenames[index].c_str(), *files[index]);
+                messages[index].stop();
+            }
+        }));
+    }
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    bool result = true;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        if(result && isIndependent(components, *files[i]))
+        {
+            messages[i].replay();
+            result = status[i];
+            components.adopt(files[i]);
+        }
+        else
+        {
+            delete files[i];
+            result = result && readFile(filenames[i].c_str(), components);
+        }
+    }
+
+    return result;
+}
+
+// Drops the components that were not asked for with --component. Sources
+// of typed copies are read only to resolve those copies. The first requested
+// copy of each type takes over as the source, so the output does not refer
+// to a component it doesn't contain.
+static void selectComponents(Components& components, const list<string>& selected)
+{
+    set<string> names(selected.begin(), selected.end());
+    map<string, Component*> removed;
+    vector<Component*> all = components.get();
+    for(size_t i = 0; i < all.size(); i++)
+    {
+        if(all[i] && !names.count(all[i]->getName()))
+        {
+            removed[all[i]->getName()] = all[i];
+            components.remove(all[i]->getName(), all[i]);
+        }
+    }
+
+    map<string, Component*> sources;
+    const vector<Component*>& kept = components.get();
+    for(size_t i = 0; i < kept.size(); i++)
+    {
+        Component* component = kept[i];
+        if(!component || !component->isTypeIDCopy())
+        {
+            continue;
+        }
+
+        map<string, Component*>::iterator source = removed.find(component->getTypeIDCopy());
+        if(source == removed.end())
+        {
+            continue;
+        }
+
+        Component*& replacement = sources[source->first];
+        if(replacement)
+        {
+            component->setTypeID(component->getTypeID(), replacement->getName());
+            continue;
+        }
+
+        replacement = component;
+        component->setTypeID(component->getTypeID(), component->getName());
+
+        const vector<Register*>& regs = component->get();
+        for(size_t j = 0; j < regs.size(); j++)
+        {
+            if(regs[j] && regs[j]->getParent() == source->second)
+            {
+                regs[j]->setParent(component);
+            }
+        }
+    }
+}
+
+struct Output {
+    string file;
+    string forced;
+
+    const char* type() const { return forced.empty() ? NULL : forced.c_str(); }
+};
+
+// FILE:TYPE selects the writer by TYPE instead of the file extension.
+static Output parseOutput(const string& name, const char* force_ext)
+{
+    Output output = { name, force_ext ? force_ext : "" };
+    size_t colon = name.find_last_of(':');
+    if(colon != string::npos && colon + 1 < name.length() && name.find('/', colon) == string::npos)
+    {
+        output.file = name.substr(0, colon);
+        output.forced = name.substr(colon + 1);
+    }
+    return output;
+}
+
+static bool writeOutput(const Output& output, Writer& writer, const CompiledModel& model)
+{
+    Diagnostics::status("Writing output file: %s", output.file.c_str());
+    if(!writer.write(model) || !writer.commit())
+    {
+        Diagnostics::error("Failed to write: %s", output.file.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Writers using only the compiled model run on their own threads while the
+// others take turns on this one. Messages are held per output and printed in
+// command line order.
+static bool writeOutputs(const vector<Output>& outputs, const vector<Writer*>& writers, const CompiledModel& model, unsigned int jobs)
+{
+    if(jobs < 2 || writers.size() < 2)
+    {
+        for(size_t i = 0; i < writers.size(); i++)
+        {
+            if(!writeOutput(outputs[i], *writers[i], model))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    vector<char> status(writers.size());
+    vector<DiagnosticsCapture> messages(writers.size());
+    vector<thread> workers;
+    for(size_t i = 0; i < writers.size(); i++)
+    {
+        if(writers[i]->usesCompiledModelOnly())
+        {
+            workers.push_back(thread([&, i]() {
+                messages[i].start();
+                status[i] = writeOutput(outputs[i], *writers[i], model);
+                messages[i].stop();
+            }));
+        }
+    }
+
+    for(size_t i = 0; i < writers.size(); i++)
+    {
+        if(!writers[i]->usesCompiledModelOnly())
+        {
+            messages[i].start();
+            status[i] = writeOutput(outputs[i], *writers[i], model);
+            messages[i].stop();
+        }
+    }
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    bool result = true;
+    for(size_t i = 0; i < writers.size(); i++)
+    {
+        messages[i].replay();
+        result = result && status[i];
+    }
+    return result;
+}
+
 int main(int argc, char *argv[])
 {
+    // Before any pugixml document is created.
+    XMLArena::install();
+
     OptionParser parser = OptionParser()
         // .usage(usage)
         // .version(version)
@@ -73,83 +323,174 @@ int main(int argc, char *argv[])
     ;
 
     parser.set_defaults("merge-addr", "0");
+    parser.set_defaults("stream", "0");
+    parser.set_defaults("jobs", "1");
+    parser.set_defaults("quiet", "0");
+    parser.set_defaults("verbose", "0");
     parser.set_defaults("project", "<PROJECT>");
 
     parser.add_option("-a", "--merge-addr").action("store_true").dest("merge-addr").help("Merge register by addresses for duplicate components");
     parser.add_option("-n", "--merge-name").action("store_false").dest("merge-addr").help("Merge register by names for duplicate components");
     parser.add_option("-p", "--project").dest("project").help("Sets the project name to replace <PROJECT> with");
     parser.add_option("-t", "--type").dest("type") .help("Overrides the output file type");
+    parser.add_option("-s", "--stream").action("store_true").dest("stream").help("Read IP-XACT input one address block at a time to bound memory use");
+    parser.add_option("-j", "--jobs").dest("jobs").help("Number of threads used to read input files and write component files");
+    parser.add_option("-c", "--cache-dir").dest("cache-dir").help("Directory used to cache the parsed model between runs");
+    parser.add_option("-q", "--quiet").action("store_true").dest("quiet").help("Only print warnings and errors");
+    parser.add_option("-v", "--verbose").action("count").dest("verbose").help("Print more details, repeat for per element tracing");
+    parser.add_option("-o", "--output").action("append").dest("output").metavar("FILE[:TYPE]").help("Write FILE, may be repeated. All arguments are then inputs");
+    parser.add_option("--component").action("append").dest("component").metavar("NAME").help("Only read and write the named component, may be repeated");
 
     Values& options = parser.parse_args(argc, argv);
     gOptions = &options;
     vector<string> args = parser.args();
 
-    if(args.size() < 2)
+    int verbose = options.get("verbose");
+    if(options.get("quiet"))
+    {
+        Diagnostics::setVerbosity(Diagnostics::Warning);
+    }
+    else if(verbose)
+    {
+        Diagnostics::setVerbosity(verbose > 1 ? Diagnostics::Debug : Diagnostics::Info);
+    }
+
+    // Without -o the last argument is the only output.
+    const char* force_ext = options.is_set("type") ? options["type"].c_str() : NULL;
+    vector<Output> outputs;
+    vector<string> inputs(args);
+    if(options.is_set("output"))
+    {
+        const list<string>& names = options.all("output");
+        for(list<string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        {
+            outputs.push_back(parseOutput(*it, force_ext));
+        }
+    }
+    else if(!inputs.empty())
+    {
+        Output output = { inputs.back(), force_ext ? force_ext : "" };
+        outputs.push_back(output);
+        inputs.pop_back();
+    }
+
+    if(inputs.empty() || outputs.empty())
     {
         parser.print_help();
         exit(-1);
     }
 
-    const char* outname = args.back().c_str();
-    const char* force_ext = options.is_set("type") ? options["type"].c_str() : NULL;
+    bool descriptions = false;
+    for(size_t i = 0; i < outputs.size(); i++)
+    {
+        descriptions = descriptions || WriterFactory::usesDescriptions(outputs[i].file.c_str(), outputs[i].type());
+    }
+    Reader::setDescriptions(descriptions);
 
 
-    vector<string>::const_iterator it = args.begin();
-    for (; it+1 != args.end(); ++it) {
-        const char* filename = it->c_str();
-        fprintf(stdout, "Reading file: %s\n", filename);
+    ModelCache cache(options.is_set("cache-dir") ? options["cache-dir"] : "");
+    bool cached = false;
+    if(options.is_set("cache-dir"))
+    {
+        vector<string> selected;
+        if(options.is_set("component"))
+        {
+            selected.assign(options.all("component").begin(), options.all("component").end());
+        }
 
-        Reader* myReader = ReaderFactory::open(filename, gComponents);
-        if(myReader && myReader->is_open())
+        if(cache.computeKey(inputs, options.get("merge-addr"), descriptions, selected) && cache.load(gComponents))
         {
-            if(!myReader->read())
-            {
-                fprintf(stderr, "Reader failed to read file: %s\n", filename);
-                exit(EXIT_FAILURE);
-            }
+            Diagnostics::status("Loaded cached model: %s", cache.getPath().c_str());
+            cached = true;
         }
-        else
+    }
+
+    int jobs = options.get("jobs");
+    if(!cached && jobs > 1 && inputs.size() > 1)
+    {
+        if(!readFiles(inputs, gComponents, jobs))
         {
-            fprintf(stderr, "Unable to open input file '%s' for reading\n", filename);
             exit(EXIT_FAILURE);
         }
-        delete myReader;
+    }
+    else
+    {
+        vector<string>::const_iterator it = inputs.begin();
+        for (; !cached && it != inputs.end(); ++it) {
+            if(!readFile(it->c_str(), gComponents))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
     }
 
-    // Attempt to open output file writer.
-    fprintf(stdout, "Opening output file: %s\n", outname);
-    Writer* myWriter = WriterFactory::create(outname, force_ext);
+    if(!cached && options.is_set("component"))
+    {
+        selectComponents(gComponents, options.all("component"));
+    }
 
-    if(!myWriter)
+    if(!cached && options.is_set("cache-dir") && !cache.save(gComponents))
     {
-        fprintf(stderr, "Unable to create file writer for '%s'.\n", outname);
-        exit(EXIT_FAILURE);
+        Diagnostics::warning("Warning: unable to write model cache '%s'", cache.getPath().c_str());
     }
-    else
+
+    // Report registers sharing address space within a component.
+    const std::vector<Component*>& componentList = gComponents.get();
+    for(size_t i = 0; i < componentList.size(); i++)
     {
-        if(!myWriter->is_open())
+        Component* component = componentList[i];
+        if(component)
         {
-            fprintf(stderr, "Unable to open output file '%s' for writing\n", outname);
-            delete myWriter;
-            exit(EXIT_FAILURE);
+            std::vector<std::pair<Register*, Register*> > overlaps = component->getOverlaps();
+            for(size_t j = 0; j < overlaps.size(); j++)
+            {
+                Diagnostics::warning("Warning: component '%s' registers '%s' (0x%llx) and '%s' (0x%llx) overlap.",
+                    component->getName().c_str(),
+                    overlaps[j].first->getName().c_str(), (unsigned long long)overlaps[j].first->getAddr(),
+                    overlaps[j].second->getName().c_str(), (unsigned long long)overlaps[j].second->getAddr());
+            }
         }
     }
 
-    fprintf(stdout, "Writing output file: %s\n", outname);
-
-    if(myWriter)
+    // Attempt to open output file writers.
+    vector<Writer*> writers;
+    for(size_t i = 0; i < outputs.size(); i++)
     {
-        bool result = myWriter->write(gComponents);
+        const char* outname = outputs[i].file.c_str();
+        Diagnostics::status("Opening output file: %s", outname);
+        Writer* myWriter = WriterFactory::create(outname, outputs[i].type());
 
-        delete myWriter;
-
-        if(!result)
+        if(!myWriter)
         {
-            fprintf(stderr, "Failed to write: %s\n", outname);
+            Diagnostics::error("Unable to create file writer for '%s'.", outname);
             exit(EXIT_FAILURE);
         }
+        else
+        {
+            if(!myWriter->is_open())
+            {
+                Diagnostics::error("Unable to open output file '%s' for writing", outname);
+                delete myWriter;
+                exit(EXIT_FAILURE);
+            }
+        }
+        writers.push_back(myWriter);
+    }
+
+    // Writers only read the model from here on.
+    CompiledModel model(gComponents);
+    if(!writeOutputs(outputs, writers, model, jobs))
+    {
+        exit(EXIT_FAILURE);
     }
 
+    for(size_t i = 0; i < writers.size(); i++)
+    {
+        delete writers[i];
+    }
+
+    Diagnostics::status("Updated %u of %u output files.", OutputFile::getUpdated(), OutputFile::getCount());
+
     // for(std::map<std::string, Component*>::const_iterator it =
     //     gComponents.begin(); it != gComponents.end(); ++it)
     // {
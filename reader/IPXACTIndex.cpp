@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       reader/IPXACTIndex.cpp
+///
+/// @project    ipxact
+///
+/// @brief      IP-XACT address block index.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <IPXACTIndex.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using namespace std;
+
+// Bump whenever the layout or meaning of a record changes.
+#define INDEX_VERSION   1
+
+static const char INDEX_MAGIC[8] = { 'I', 'P', 'X', 'I', 'N', 'D', 'E', 'X' };
+
+struct IndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t blocks;
+    uint64_t size;
+    int64_t  seconds;
+    int64_t  nanoseconds;
+};
+
+struct IndexBlock {
+    uint64_t begin;
+    uint64_t end;
+    uint64_t unitsBegin;
+    uint64_t unitsEnd;
+    uint32_t nameLength;
+    uint32_t typeLength;
+};
+
+IPXACTIndex::IPXACTIndex(uint64_t size, int64_t seconds, int64_t nanoseconds) :
+    mSize(size), mSeconds(seconds), mNanoseconds(nanoseconds)
+{
+}
+
+IPXACTIndex::~IPXACTIndex()
+{
+}
+
+bool IPXACTIndex::load(const string& path)
+{
+    ifstream file(path.c_str(), ios::in | ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    vector<char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    if(data.size() < sizeof(IndexHeader))
+    {
+        return false;
+    }
+
+    IndexHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if(memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) ||
+       header.version != INDEX_VERSION ||
+       header.size != mSize ||
+       header.seconds != mSeconds ||
+       header.nanoseconds != mNanoseconds)
+    {
+        return false;
+    }
+
+    vector<Block> blocks(header.blocks);
+    size_t offset = sizeof(header);
+    for(size_t i = 0; i < blocks.size(); i++)
+    {
+        IndexBlock record;
+        if(data.size() - offset < sizeof(record))
+        {
+            return false;
+        }
+        memcpy(&record, &data[offset], sizeof(record));
+        offset += sizeof(record);
+
+        if(record.begin > record.end || record.end > mSize ||
+           record.unitsBegin > record.unitsEnd || record.unitsEnd > mSize ||
+           data.size() - offset < (uint64_t)record.nameLength + record.typeLength)
+        {
+            return false;
+        }
+
+        Block& block = blocks[i];
+        block.begin = record.begin;
+        block.end = record.end;
+        block.unitsBegin = record.unitsBegin;
+        block.unitsEnd = record.unitsEnd;
+        block.name.assign(&data[offset], record.nameLength);
+        offset += record.nameLength;
+        block.typeID.assign(&data[offset], record.typeLength);
+        offset += record.typeLength;
+    }
+
+    if(offset != data.size())
+    {
+        return false;
+    }
+
+    mBlocks.swap(blocks);
+    return true;
+}
+
+bool IPXACTIndex::save(const string& path) const
+{
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.blocks = mBlocks.size();
+    header.size = mSize;
+    header.seconds = mSeconds;
+    header.nanoseconds = mNanoseconds;
+
+    // Write to a private file first so concurrent runs never see a partial
+    // index.
+    ostringstream temp;
+    temp << path << ".tmp." << getpid();
+    string tempPath = temp.str();
+
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    bool status = fwrite(&header, sizeof(header), 1, file) == 1;
+    for(size_t i = 0; status && i < mBlocks.size(); i++)
+    {
+        const Block& block = mBlocks[i];
+        IndexBlock record;
+        memset(&record, 0, sizeof(record));
+        record.begin = block.begin;
+        record.end = block.end;
+        record.unitsBegin = block.unitsBegin;
+        record.unitsEnd = block.unitsEnd;
+        record.nameLength = block.name.length();
+        record.typeLength = block.typeID.length();
+
+        status = fwrite(&record, sizeof(record), 1, file) == 1 &&
+                 fwrite(block.name.data(), 1, block.name.length(), file) == block.name.length() &&
+                 fwrite(block.typeID.data(), 1, block.typeID.length(), file) == block.typeID.length();
+    }
+    status = (fclose(file) == 0) && status;
+
+    if(!status || rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+vector<const IPXACTIndex::Block*> IPXACTIndex::select(const set<string>& names) const
+{
+    // A typed copy takes its registers from the first component with the
+    // same type, which has to be read as well.
+    set<string> types;
+    for(size_t i = 0; i < mBlocks.size(); i++)
+    {
+        if(names.count(mBlocks[i].name) && !mBlocks[i].typeID.empty())
+        {
+            types.insert(mBlocks[i].typeID);
+        }
+    }
+
+    vector<const Block*> selected;
+    set<string> defined;
+    for(size_t i = 0; i < mBlocks.size(); i++)
+    {
+        const Block& block = mBlocks[i];
+        bool source = types.count(block.typeID) && defined.insert(block.typeID).second;
+        if(source || names.count(block.name))
+        {
+            selected.push_back(&block);
+        }
+    }
+
+    return selected;
+}
@@ -43,18 +43,27 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <IPXACTReader.hpp>
+#include <IPXACTIndex.hpp>
+#include <Diagnostics.hpp>
 #include <Number.hpp>
+#include <XMLScanner.hpp>
 
 #include <pugixml.hpp>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 
+#include <functional>
+#include <set>
 #include <string>
 #include <sstream>
 
 using namespace pugi;
 using namespace std;
 
-IPXACTReader::IPXACTReader(const char* filename, Components& components) : Reader(filename, components)
+IPXACTReader::IPXACTReader(const char* filename, Components& components) : Reader(filename, components),
+    mFilename(filename)
 {
 }
 
@@ -65,15 +74,27 @@ IPXACTReader::~IPXACTReader()
 
 bool IPXACTReader::read()
 {
-    // cout << "IPXACTReader::read" << endl;
-    string tmp;
-    string xml;
-    while(std::getline(mFile, tmp)) {
-        xml += tmp;
+    XMLArena::Scope scope(mArena);
+    optparse::Values& options = *gOptions;
+    if(options.is_set("component"))
+    {
+        return readSelected();
+    }
+
+    if(options.get("stream"))
+    {
+        return readStream();
     }
 
+    // cout << "IPXACTReader::read" << endl;
+    size_t size;
+    char* xml = mapFile(size);
+
     xml_document doc;
-    doc.load_string(xml.c_str());
+    if(xml)
+    {
+        doc.load_buffer_inplace(xml, size, pugi::parse_default);
+    }
     // cout << "IPXACTReader::parse" << endl;
 
     xml_node root = doc.document_element();
@@ -86,13 +107,389 @@ bool IPXACTReader::read()
     }
     else
     {
-        cout << "ERR";
+        Diagnostics::error("Error: unable to parse '%s'.", mFilename.c_str());
         return false;
     }
 
     return true;
 }
 
+// pugixml copies [begin, end) into the arena, the mapping stays untouched
+// since the scanner and the index still read it.
+bool IPXACTReader::parseFragment(xml_document& doc, const char* begin, const char* end)
+{
+    return begin == end || doc.load_buffer(begin, end - begin, pugi::parse_default);
+}
+
+bool IPXACTReader::readStream()
+{
+    size_t size;
+    const char* data = viewFile(size);
+    return scanBlocks(data, size, NULL);
+}
+
+// Only the address blocks of the requested components are parsed, located
+// through an index. The index is kept in the cache directory when one is
+// given, the input's directory is never written to.
+bool IPXACTReader::readSelected()
+{
+    optparse::Values& options = *gOptions;
+    size_t size;
+    const char* data = viewFile(size);
+    struct stat info;
+    if(!data || fstat(mFD, &info) != 0)
+    {
+        Diagnostics::error("Error: unable to parse '%s'.", mFilename.c_str());
+        return false;
+    }
+
+    string path;
+    if(options.is_set("cache-dir"))
+    {
+        char* real = realpath(mFilename.c_str(), NULL);
+        ostringstream cached;
+        cached << options["cache-dir"] << "/" << std::hex << std::hash<string>()(real ? real : mFilename) << ".ipxi";
+        path = cached.str();
+        free(real);
+    }
+
+    IPXACTIndex index(info.st_size, info.st_mtim.tv_sec, info.st_mtim.tv_nsec);
+    if(path.empty() || !index.load(path))
+    {
+        if(!scanBlocks(data, size, &index))
+        {
+            return false;
+        }
+
+        if(!path.empty() && !index.save(path))
+        {
+            Diagnostics::warning("Warning: unable to write index '%s'", path.c_str());
+        }
+    }
+
+    const list<string>& components = options.all("component");
+    set<string> names(components.begin(), components.end());
+    vector<const IPXACTIndex::Block*> blocks = index.select(names);
+
+    bool status = true;
+    for(size_t i = 0; i < blocks.size(); i++)
+    {
+        const IPXACTIndex::Block& block = *blocks[i];
+        const char* units = block.unitsBegin != block.unitsEnd ? data + block.unitsBegin : NULL;
+        if(!parseBlock(data + block.begin, data + block.end, units, data + block.unitsEnd))
+        {
+            status = false;
+        }
+        mArena.reset();
+    }
+
+    return status;
+}
+
+// Parses one address block and the ipxact:addressUnitBits element it uses.
+bool IPXACTReader::parseBlock(const char* begin, const char* end, const char* unitsBegin, const char* unitsEnd)
+{
+    xml_document units;
+    if(unitsBegin)
+    {
+        string text;
+        for(const char* p = unitsBegin; p != unitsEnd; p++)
+        {
+            if(*p != '\n') text += *p;
+        }
+        units.load_buffer(text.data(), text.size(), pugi::parse_default);
+    }
+
+    // parse registers
+    Diagnostics::debug("**********************");
+
+    xml_document doc;
+    return parseFragment(doc, begin, end) &&
+           parseComponent(doc.first_child(), units.first_child());
+}
+
+static bool is_plain(const char* begin, const char* end)
+{
+    for(const char* p = begin; p != end; p++)
+    {
+        if(*p == '&' || *p == '\r' || *p == '\n')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds the component name and type parseComponent() would use without
+// building the block. Text needing entity or line break handling falls
+// back to parsing the block.
+void IPXACTReader::describeBlock(const char* begin, const char* content, const char* end, IPXACTIndex::Block& block)
+{
+    XMLScanner scanner(content, end);
+    bool leading = true;
+    bool typed = false;
+    for(;;)
+    {
+        XMLScanner::Token token = scanner.next();
+        if(token != XMLScanner::StartTag && token != XMLScanner::EmptyTag)
+        {
+            return;
+        }
+
+        bool name = scanner.isName("ipxact:name");
+        bool type = scanner.isName("ipxact:typeIdentifier");
+        leading = leading && name;
+        if((name && leading) || (type && !typed))
+        {
+            string text;
+            if(token == XMLScanner::StartTag)
+            {
+                const char* first = scanner.getPosition();
+                const char* last = (const char*)memchr(first, '<', end - first);
+                if(!last || last + 1 == end || last[1] != '/' || !is_plain(first, last))
+                {
+                    break;
+                }
+                text.assign(first, last);
+            }
+
+            if(name)
+            {
+                block.name = text;
+            }
+            else
+            {
+                block.typeID = text;
+                typed = true;
+            }
+        }
+
+        if(token == XMLScanner::StartTag && !scanner.skipElement())
+        {
+            return;
+        }
+    }
+
+    xml_document doc;
+    block.name.clear();
+    block.typeID.clear();
+    if(!parseFragment(doc, begin, end))
+    {
+        return;
+    }
+
+    leading = true;
+    typed = false;
+    for (xml_node current = doc.first_child().first_child(); current; current = current.next_sibling())
+    {
+        Tag tag = classify(current.name());
+        leading = leading && tag == TagName;
+        if(leading)
+        {
+            block.name = text(current.child_value());
+        }
+        else if(tag == TagTypeIdentifier && !typed)
+        {
+            block.typeID = text(current.child_value());
+            typed = true;
+        }
+    }
+}
+
+// Walks the file mirroring parseElement(). Each address block is parsed on
+// its own, or only recorded when building an index.
+bool IPXACTReader::scanBlocks(const char* data, size_t size, IPXACTIndex* index)
+{
+    XMLScanner scanner(data, data + size);
+
+    // Find the root element.
+    XMLScanner::Token token = data ? scanner.next() : XMLScanner::End;
+    if(token != XMLScanner::StartTag && token != XMLScanner::EmptyTag)
+    {
+        Diagnostics::error("Error: unable to parse '%s'.", mFilename.c_str());
+        return false;
+    }
+
+    // Each open element mirrors a parseElement() call: its status, and the
+    // next ipxact:addressUnitBits sibling found for its address blocks.
+    struct Level {
+        bool status;
+        const char* unitsSearched;
+        const char* unitsBegin;
+        const char* unitsEnd;
+    };
+    std::vector<Level> levels;
+    Level root = { true, NULL, NULL, NULL };
+    if(token == XMLScanner::StartTag)
+    {
+        levels.push_back(root);
+    }
+
+    while(!levels.empty())
+    {
+        token = scanner.next();
+        if(token == XMLScanner::End || token == XMLScanner::Error)
+        {
+            Diagnostics::error("Error: unexpected end of XML.");
+            return false;
+        }
+
+        if(token == XMLScanner::EndTag)
+        {
+            bool status = levels.back().status;
+            levels.pop_back();
+            if(levels.empty())
+            {
+                return status;
+            }
+            levels.back().status = status;
+            continue;
+        }
+
+        Level& level = levels.back();
+        if(scanner.isName("ipxact:addressBlock"))
+        {
+            const char* begin = scanner.getTagBegin();
+            const char* content = scanner.getPosition();
+            if(token == XMLScanner::StartTag && !scanner.skipElement())
+            {
+                Diagnostics::error("Error: unexpected end of XML.");
+                return false;
+            }
+            const char* end = scanner.getPosition();
+
+            // parseComponent() uses the first ipxact:addressUnitBits
+            // following the block, search ahead once per sibling run.
+            if(!level.unitsSearched || end > level.unitsSearched)
+            {
+                XMLScanner ahead(end, data + size);
+                level.unitsBegin = NULL;
+                level.unitsEnd = NULL;
+                for(;;)
+                {
+                    XMLScanner::Token next = ahead.next();
+                    level.unitsSearched = ahead.getTagBegin();
+                    if(next == XMLScanner::StartTag || next == XMLScanner::EmptyTag)
+                    {
+                        if(ahead.isName("ipxact:addressUnitBits"))
+                        {
+                            if(next == XMLScanner::StartTag) ahead.skipElement();
+                            level.unitsBegin = level.unitsSearched;
+                            level.unitsEnd = ahead.getPosition();
+                            break;
+                        }
+
+                        if(next == XMLScanner::StartTag && !ahead.skipElement())
+                        {
+                            level.unitsSearched = data + size;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if(next != XMLScanner::EndTag)
+                        {
+                            level.unitsSearched = data + size;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            if(index)
+            {
+                IPXACTIndex::Block block;
+                block.begin = begin - data;
+                block.end = end - data;
+                block.unitsBegin = level.unitsBegin ? level.unitsBegin - data : 0;
+                block.unitsEnd = level.unitsBegin ? level.unitsEnd - data : 0;
+                if(token == XMLScanner::StartTag)
+                {
+                    describeBlock(begin, content, end, block);
+                }
+                index->add(block);
+            }
+            else if(!parseBlock(begin, end, level.unitsBegin, level.unitsEnd))
+            {
+                level.status = false;
+            }
+
+            mArena.reset();
+            releaseFile(end - data);
+        }
+        else if(token == XMLScanner::EmptyTag)
+        {
+            // No children to parse.
+        }
+        else if(scanner.isName("ipxact:addressUnitBits") || !level.status)
+        {
+            // Skip, handled with the address blocks or after a failure.
+            if(!scanner.skipElement())
+            {
+                Diagnostics::error("Error: unexpected end of XML.");
+                return false;
+            }
+        }
+        else
+        {
+            Level child = { true, NULL, NULL, NULL };
+            levels.push_back(child);
+        }
+    }
+
+    return true;
+}
+
+
+#define TAG_KEY(__length__, __first__) (((__length__) << 8) | (unsigned char)(__first__))
+
+// The length and first character after the ipxact: prefix are unique for
+// every element the reader handles, one compare confirms the match.
+IPXACTReader::Tag IPXACTReader::classify(const char* name)
+{
+    static const char prefix[] = "ipxact:";
+    if(strncmp(name, prefix, sizeof(prefix) - 1))
+    {
+        return TagUnknown;
+    }
+
+    name += sizeof(prefix) - 1;
+    size_t length = strlen(name);
+    if(!length || length > 0xFF)
+    {
+        return TagUnknown;
+    }
+
+    const char* text;
+    Tag tag;
+    switch(TAG_KEY(length, name[0]))
+    {
+        case TAG_KEY(3, 'd'):    text = "dim";               tag = TagDim; break;
+        case TAG_KEY(4, 'n'):    text = "name";              tag = TagName; break;
+        case TAG_KEY(4, 's'):    text = "size";              tag = TagSize; break;
+        case TAG_KEY(5, 'f'):    text = "field";             tag = TagField; break;
+        case TAG_KEY(5, 'r'):    text = "range";             tag = TagRange; break;
+        case TAG_KEY(5, 'v'):    text = "value";             tag = TagValue; break;
+        case TAG_KEY(6, 'a'):    text = "access";            tag = TagAccess; break;
+        case TAG_KEY(6, 'r'):    text = "resets";            tag = TagResets; break;
+        case TAG_KEY(8, 'b'):    text = "bitWidth";          tag = TagBitWidth; break;
+        case TAG_KEY(8, 'r'):    text = "register";          tag = TagRegister; break;
+        case TAG_KEY(9, 'b'):    text = "bitOffset";         tag = TagBitOffset; break;
+        case TAG_KEY(11, 'b'):   text = "baseAddress";       tag = TagBaseAddress; break;
+        case TAG_KEY(11, 'd'):   text = "description";       tag = TagDescription; break;
+        case TAG_KEY(12, 'a'):   text = "addressBlock";      tag = TagAddressBlock; break;
+        case TAG_KEY(13, 'a'):   text = "addressOffset";     tag = TagAddressOffset; break;
+        case TAG_KEY(14, 't'):   text = "typeIdentifier";    tag = TagTypeIdentifier; break;
+        case TAG_KEY(15, 'a'):   text = "addressUnitBits";   tag = TagAddressUnitBits; break;
+        case TAG_KEY(15, 'e'):   text = "enumeratedValue";   tag = TagEnumeratedValue; break;
+        case TAG_KEY(16, 'e'):   text = "enumeratedValues";  tag = TagEnumeratedValues; break;
+        case TAG_KEY(16, 'v'):   text = "vendorExtensions";  tag = TagVendorExtensions; break;
+        default:                 return TagUnknown;
+    }
+
+    return memcmp(name, text, length) ? TagUnknown : tag;
+}
+
 bool IPXACTReader::parseElement(pugi::xml_node& elem)
 {
     bool status = true;
@@ -105,17 +502,18 @@ bool IPXACTReader::parseElement(pugi::xml_node& elem)
     for (xml_node child = elem.first_child(); child; child = child.next_sibling())
     {
         // do something with each child element
-        if(child.name() == string("ipxact:addressBlock"))
+        Tag tag = classify(child.name());
+        if(tag == TagAddressBlock)
         {
             // parse registers
-            cout << "**********************" << endl;
+            Diagnostics::debug("**********************");
 
-            if(!parseComponent(child))
+            if(!parseComponent(child, child.next_sibling("ipxact:addressUnitBits")))
             {
                 status = false;
             }
         }
-        else if(child.name() == string("ipxact:addressUnitBits"))
+        else if(tag == TagAddressUnitBits)
         {
             // Skip, already handled in parseComponent
         }
@@ -128,21 +526,21 @@ bool IPXACTReader::parseElement(pugi::xml_node& elem)
     return status;
 }
 
-bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
+bool IPXACTReader::parseComponent(const pugi::xml_node& elem, const pugi::xml_node& addressable)
 {
     bool update = false;
     bool status = true;
     bool noregs = false;
     int addressUnitBits = 8;
     string componentname;
+    Component* component = NULL;
 
     // Determine addressable unit for this block, if set.
-    const xml_node addressable = elem.next_sibling("ipxact:addressUnitBits");
     if(addressable)
     {
         if(addressable.child_value())
         {
-            Number bits(addressable.child_value());
+            Number bits(text(addressable.child_value()));
 
             if(bits.isValid())
             {
@@ -150,71 +548,76 @@ bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
             }
             else
             {
-                cerr << "Error: ipxact:addressUnitBits with invalid text: " << addressable.child_value() << endl;
+                Diagnostics::error("Error: ipxact:addressUnitBits with invalid text: %s", text(addressable.child_value()).c_str());
                 status = false;
             }
         }
     }
 
-    // First pass: find component name
-    for (xml_node current = elem.first_child(); current; current = current.next_sibling())
+    // The component name leads the block, the component is looked up once
+    // the first other element is reached.
+    for (xml_node current = elem.first_child(); ; current = current.next_sibling())
     {
-        if(string(current.name()) == "ipxact:name")
+        Tag tag = current ? classify(current.name()) : TagUnknown;
+        if(!component)
         {
-            componentname = current.child_value();
-        }
-    }
+            if(current && tag == TagName)
+            {
+                componentname = text(current.child_value());
+                continue;
+            }
 
-    Component* component = mComponents.get(componentname);
-    if(!component)
-    {
-        component = new Component(componentname);
-        mComponents.set(componentname, component);
-    }
-    else
-    {
-        // component already exists, don't add new elements, just update them.
-        update = true;
-    }
+            component = mComponents.get(componentname);
+            if(!component)
+            {
+                component = mComponents.create<Component>(componentname);
+                mComponents.set(componentname, component);
+            }
+            else
+            {
+                // component already exists, don't add new elements, just update them.
+                update = true;
+            }
 
-    component->setAddressUnitBits(addressUnitBits);
+            component->setAddressUnitBits(addressUnitBits);
 
-    // Second pass.
-    if(component)
-    {
-        // if(!update) cout << "Created component "  << componentname << endl;
-        // else        cout << "Updating component " << componentname << endl;
+            // if(!update) cout << "Created component "  << componentname << endl;
+            // else        cout << "Updating component " << componentname << endl;
+        }
 
+        if(!current || !status)
+        {
+            break;
+        }
 
-        for (xml_node current = elem.first_child(); current && status; current = current.next_sibling())
+        switch(tag)
         {
-            if(string(current.name()) == "ipxact:vendorExtensions")
+            case TagVendorExtensions:
             {
                 xml_node pModuleName = current.child("hdlModuleName");
 
                 if(pModuleName && pModuleName.child_value())
                 {
-                    component->setModuleName(pModuleName.child_value());
+                    component->setModuleName(text(pModuleName.child_value()));
                 }
+                break;
             }
 
-            if(string(current.name()) == "ipxact:description")
-            {
-                if(current.child_value())
+            case TagDescription:
+                if(sDescriptions && current.child_value())
                 {
                     if(update)
                     {
                         // cout << "Replacing " << componentname << " description with " << current.child_value() << endl;
                     }
-                    component->setDescription(current.child_value());
+                    component->setDescription(text(current.child_value()));
                 }
-            }
+                break;
 
-            if(string(current.name()) == "ipxact:range")
-            {
+            case TagRange:
                 if(current.child_value())
                 {
-                    Number range(current.child_value());
+                    Number range(text(current.child_value()));
                     if(range.isValid())
                     {
                         component->setRange(range.getValue());
@@ -222,16 +625,15 @@ bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
                     else
                     {
                         status = false;
-                        cerr << "Error: ipxact:range with invalid text." << endl;
+                        Diagnostics::error("Error: ipxact:range with invalid text.");
                     }
                 }
-            }
+                break;
 
-            if(string(current.name()) == "ipxact:baseAddress")
-            {
+            case TagBaseAddress:
                 if(current.child_value())
                 {
-                    Number base(current.child_value());
+                    Number base(text(current.child_value()));
                     if(base.isValid())
                     {
                         if(update)
@@ -244,29 +646,28 @@ bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
                     else
                     {
                         status = false;
-                        cerr << "Error: ipxact:baseAddress with invalid text." << endl;
+                        Diagnostics::error("Error: ipxact:baseAddress with invalid text.");
                     }
                 }
-            }
+                break;
 
-            if(string(current.name()) == "ipxact:typeIdentifier")
+            case TagTypeIdentifier:
             {
-                const char *type = current.child_value();
-                if(type)
+                if(current.child_value())
                 {
-                    string typeID = type;
+                    string typeID = text(current.child_value());
                     Component* source_element = mComponents.getElementWithTypeID(typeID);
-                    if(source_element)
+                    if(source_element && source_element != component)
                     {
-                        const std::list<Register*> &regList = source_element->get();
-                        std::list<Register*>::const_iterator regit;
+                        const std::vector<Register*> &regList = source_element->get();
+                        std::vector<Register*>::const_iterator regit;
                         for(regit = regList.begin(); regit != regList.end(); regit++)
                         {
                             Register* const reg = *regit;
                             if(reg)
                             {
-                                std::string regname = reg->getName();
-                                Register* realreg = source_element->get(regname);
+                                const std::string& regname = reg->getName();
+                                Register* realreg = source_element->get(reg->getNameSymbol());
                                 // component->set(regname, reg);
                                 component->set(regname, realreg);
                                 noregs = true;
@@ -277,21 +678,20 @@ bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
                         // *component = *source_element;
 
                         // This is a copy.
-                        component->setTypeID(type, source_element->getName());
+                        component->setTypeID(typeID, source_element->getName());
                     }
                     else
                     {
-                        component->setTypeID(type, component->getName());
+                        component->setTypeID(typeID, component->getName());
                     }
                 }
+                break;
             }
 
-
-            if(string(current.name()) == "ipxact:register")
-            {
+            case TagRegister:
                 if(noregs)
                 {
-                    cout << "Unable to redefine registers for already defined component types.\n";
+                    Diagnostics::error("Unable to redefine registers for already defined component types.");
                     exit(-1);
                 }
                 else
@@ -301,36 +701,39 @@ bool IPXACTReader::parseComponent(const pugi::xml_node& elem)
                         status = false;
                     }
                 }
-            }
+                break;
+
+            default:
+                break;
         }
     }
 
     return status;
 }
 
-RegisterBitmap::Type IPXACTReader::registerType(const string& type) const
+RegisterBitmap::Type IPXACTReader::registerType(const char* type) const
 {
-    if(type == "read-only")
+    if(!strcmp(type, "read-only"))
     {
         return RegisterBitmap::ReadOnly;
     }
 
-    if(type == "write-only")
+    if(!strcmp(type, "write-only"))
     {
         return RegisterBitmap::WriteOnly;
     }
 
-    if(type == "read-write")
+    if(!strcmp(type, "read-write"))
     {
         return RegisterBitmap::ReadWrite;
     }
 
-    if(type == "writeOnce")
+    if(!strcmp(type, "writeOnce"))
     {
         return RegisterBitmap::WriteOnce;
     }
 
-    if(type == "read-writeOnce")
+    if(!strcmp(type, "read-writeOnce"))
     {
         return RegisterBitmap::ReadWriteOnce;
     }
@@ -343,197 +746,233 @@ bool IPXACTReader::parseRegister(const pugi::xml_node& elem, Component& componen
 {
     bool status = true;
     string regname;
-    Number* regaddr = NULL;
-    Number* dimensions = NULL;
-    bool has_bits = false;
-    const char* typeName = NULL;
-
-    // First pass: find component name
-    for (xml_node current = elem.first_child(); current && status; current = current.next_sibling())
+    xml_node regaddr;
+    xml_node dimensions;
+    xml_node typeName;
+    Register* reg = NULL;
+    bool hasID = false;
+
+    // Elements ahead of the first ipxact:field are needed to look up the
+    // register, description and size are held until it is known.
+    xml_node description;
+    xml_node size;
+
+    for (xml_node current = elem.first_child(); ; current = current.next_sibling())
     {
-        if(string(current.name()) == "ipxact:name")
+        Tag tag = current ? classify(current.name()) : TagUnknown;
+        if(!reg && current && status && tag != TagField)
         {
-            if(current.child_value())
+            switch(tag)
             {
-                regname = current.child_value();
-                printf("Parsing registers for %s\n", regname.c_str());
+                case TagName:
+                    if(current.child_value())
+                    {
+                        regname = text(current.child_value());
+                        Diagnostics::debug("Parsing registers for %s", regname.c_str());
+                    }
+                    else
+                    {
+                        Diagnostics::error("Error: ipxact:name with no text.");
+                        status = false;
+                    }
+                    break;
+
+                case TagAddressOffset:
+                    if(current.child_value())
+                    {
+                        regaddr = current;
+                    }
+                    break;
+
+                case TagTypeIdentifier:
+                    if(current.child_value())
+                    {
+                        typeName = current;
+                    }
+                    break;
+
+                case TagDim:
+                    if(current.child_value())
+                    {
+                        dimensions = current;
+                    }
+                    break;
+
+                case TagDescription:
+                    description = current;
+                    break;
+
+                case TagSize:
+                    size = current;
+                    break;
+
+                default:
+                    break;
+            }
+            continue;
+        }
+
+        if(!reg)
+        {
+            // grab data struct
+            optparse::Values& options = *gOptions;
+            if(options.get("merge-addr") && regaddr)
+            {
+                Number address(text(regaddr.child_value()));
+                reg = mComponents.unshare(component, component.get(address.getValue()));
+                if(reg)
+                {
+                    reg->setName(regname);
+                    // Bitfields are not cleared, fields from both files are kept.
+                    if(current && tag == TagField) update = false; // force adding new bitfields, we are merging based on address.
+                }
             }
             else
             {
-                cerr << "Error: ipxact:name with no text." << endl;
-                status = false;
+                reg = mComponents.unshare(component, component.get(regname));
             }
-        }
 
-        if(string(current.name()) == "ipxact:addressOffset")
-        {
-            if(current.child_value())
+            if(!reg)
             {
-                regaddr = new Number(current.child_value());
+                // Adding a register, a typed copy can no longer share its
+                // source's registers.
+                if(component.isTypeIDCopy()) mComponents.unshare(component);
+
+                reg = mComponents.create<Register>(regname);
+                component.set(regname, reg);
+
+                if(update) Diagnostics::info("  **Register %s not found.", regname.c_str());
+                update = false; // new register, don't try to update old data, there is none.
             }
-        }
 
-        if(string(current.name()) == "ipxact:typeIdentifier")
-        {
-            if(current.child_value())
+            string typeID = typeName ? text(typeName.child_value()) : string();
+            if(typeName)
             {
-                typeName = current.child_value();
+                Register* source_element = component.getElementWithTypeID(typeID);
+
+                if(source_element && source_element != reg)
+                {
+                    // Already exist, copy everything we need.
+                    reg->setTypeID(typeID, source_element->getName());
+
+                    reg->setWidth(source_element->getWidth());
+                    reg->setDimensions(source_element->getDimensions());
+                    hasID = true;
+                }
             }
 
-        }
+            if(typeName && !hasID)
+            {
+                // First element with this type name.
+                reg->setTypeID(typeID, reg->getName());
+            }
+            // if(!update) cout << "  Created register "  << regname << endl;
+            // else        cout << "  Updating register " << regname << endl;
+            if(dimensions)
+            {
+                Number dim(text(dimensions.child_value()));
+                reg->setDimensions(dim.getValue());
+            }
 
+            if(status && description)
+            {
+                status = parseRegisterChild(description, TagDescription, *reg, update, hasID);
+            }
 
-        if(string(current.name()) == "ipxact:dim")
-        {
-            if(current.child_value())
+            if(status && size)
             {
-                dimensions = new Number(current.child_value());
+                status = parseRegisterChild(size, TagSize, *reg, update, hasID);
             }
         }
 
-        if(string(current.name()) == "ipxact:field")
+        if(!current || !status)
         {
-            has_bits = true;
+            break;
         }
-    }
-
 
-    // grab data struct
-    Register* reg;
-    optparse::Values& options = *gOptions;
-    if(options.get("merge-addr") && regaddr)
-    {
-        reg = component.get(regaddr->getValue());
-        if(reg)
+        if(tag == TagAddressOffset && current.child_value())
         {
-            reg->setName(regname);
-            reg->clear(); // remove all bitfields.
-            if(has_bits) update = false; // force adding new bitfields, we are merging based on address.
+            regaddr = current;
+        }
+        else if(!parseRegisterChild(current, tag, *reg, update, hasID))
+        {
+            status = false;
         }
-    }
-    else
-    {
-        reg = component.get(regname);
-    }
-
-    if(!reg)
-    {
-        reg = new Register(regname);
-        component.set(regname, reg);
-
-        if(update) cout << "  **Register " << regname << " not found." << endl;
-        update = false; // new register, don't try to update old data, there is none.
-    }
-    else
-    {
-        //update = true;??
     }
 
-    // Second pass.
-    if(reg)
+    if(status && regaddr)
     {
-        bool hasID = false;
-        if(typeName)
+        Number address(text(regaddr.child_value()));
+        if(address.isValid())
         {
-            string typeID = typeName;
-            Register* source_element = component.getElementWithTypeID(typeID);
-
-            if(source_element)
+            if(update)
             {
-                // Already exist, copy everything we need.
-                reg->setTypeID(typeName, source_element->getName());
-
-                reg->setWidth(source_element->getWidth());
-                reg->setDimensions(source_element->getDimensions());
-                // reg->
-                hasID = true;
+                Diagnostics::info("Replacing %s addr with 0x%llx", regname.c_str(), (unsigned long long)address.getValue());
             }
+            reg->setAddr(address.getValue());
         }
-
-        if(typeName && !hasID)
-        {
-            // First element with this type name.
-            reg->setTypeID(typeName, reg->getName());
-        }
-        // if(!update) cout << "  Created register "  << regname << endl;
-        // else        cout << "  Updating register " << regname << endl;
-        if(dimensions)
+        else
         {
-            reg->setDimensions(dimensions->getValue());
+            Diagnostics::error("Error: invalid register address.");
+            status = false;
         }
+    }
 
-        for (xml_node current = elem.first_child(); current && status; current = current.next_sibling())
-        {
-            if(string(current.name()) == "ipxact:description")
+    return status;
+}
+
+bool IPXACTReader::parseRegisterChild(const pugi::xml_node& current, Tag tag, Register& reg, bool update, bool hasID)
+{
+    bool status = true;
+
+    switch(tag)
+    {
+        case TagDescription:
+            if(sDescriptions && current.child_value())
             {
-                if(current.child_value())
+                if(update)
                 {
-                    if(update)
-                    {
-                        cout << "Replacing " << regname << " description with " << current.child_value() << endl;
-                    }
-
-                    reg->setDescription(current.child_value());
+                    Diagnostics::info("Replacing %s description with %s", reg.getName().c_str(), text(current.child_value()).c_str());
                 }
+
+                reg.setDescription(text(current.child_value()));
             }
+            break;
 
-            if(string(current.name()) == "ipxact:size")
+        case TagSize:
+            if(current.child_value())
             {
-                if(current.child_value())
+                Number width(text(current.child_value()));
+                if(width.isValid() && width.getValue())
                 {
-                    Number width(current.child_value());
-                    if(width.isValid() && width.getValue())
-                    {
-                        if(update)
-                        {
-                            cout << "Replacing " << regname << " width with " << std::dec << width.getValue() << endl;
-                        }
-
-                        reg->setWidth(width.getValue());
-                    }
-                    else
+                    if(update)
                     {
-                        cerr << "Error: ipxact:size with invalid text." << endl;
-                        status = false;
+                        Diagnostics::info("Replacing %s width with %llu", reg.getName().c_str(), (unsigned long long)width.getValue());
                     }
-                }
-            }
 
-            if(string(current.name()) == "ipxact:field")
-            {
-                if(hasID)
-                {
-                    printf("Error: ipxact:field not allowed with a typeIdentifier.\n");
-                    exit(1);
+                    reg.setWidth(width.getValue());
                 }
-
-                if(!parseRegisterBitmap(current, *reg, update))
+                else
                 {
+                    Diagnostics::error("Error: ipxact:size with invalid text.");
                     status = false;
                 }
             }
-        }
+            break;
 
-        if(status && regaddr)
-        {
-            if(regaddr->isValid())
+        case TagField:
+            if(hasID)
             {
-                if(update)
-                {
-                    cout << "Replacing " << regname << " addr with 0x" << std::hex << regaddr->getValue() << endl;
-                }
-                reg->setAddr(regaddr->getValue());
+                Diagnostics::error("Error: ipxact:field not allowed with a typeIdentifier.");
+                exit(1);
             }
-            else
-            {
-                cerr << "Error: invalid register address." << endl;
-                status = false;
-            }
-            delete regaddr;
-        }
-    }
 
+            status = parseRegisterBitmap(current, reg, update);
+            break;
 
+        default:
+            break;
+    }
 
     return status;
 }
@@ -544,19 +983,19 @@ bool IPXACTReader::parsseEnumeration(const pugi::xml_node& elem, RegisterBitmap&
     update = false;
 
     bool status = true;
-    Number* value = NULL;
+    xml_node value;
     string enumname;
 
     for (xml_node current = elem.first_child(); current; current = current.next_sibling())
     {
-        if(string(current.name()) == "ipxact:name")
+        Tag tag = classify(current.name());
+        if(tag == TagName)
         {
-            enumname = current.child_value();
+            enumname = text(current.child_value());
         }
-
-        if(string(current.name()) == "ipxact:value")
+        else if(tag == TagValue)
         {
-            value = new Number(current.child_value());
+            value = current;
         }
     }
 
@@ -567,25 +1006,24 @@ bool IPXACTReader::parsseEnumeration(const pugi::xml_node& elem, RegisterBitmap&
     {
         if(update)
         {
-            cout << "    **Enumeration " << enumname << " not found, dropping." << endl;
+            Diagnostics::info("    **Enumeration %s not found, dropping.", enumname.c_str());
         }
         else
         {
-            bitenum = new Enumeration(enumname);
+            bitenum = mComponents.create<Enumeration>(enumname);
             bitmap.set(enumname, bitenum);
         }
     }
-    // Second pass.
-    if(bitenum && value && value->isValid())
-    {
-        // if(!update) cout << "    Created enumeration "  << enumname << " : " << value->getValue() << endl;
-        // else        cout << "    Updating enumeration " << enumname << " : " << value->getValue() << endl;
-        bitenum->setValue(value->getValue());
-    }
 
-    if(value)
+    if(bitenum && value)
     {
-        delete value;
+        Number number(text(value.child_value()));
+        if(number.isValid())
+        {
+            // if(!update) cout << "    Created enumeration "  << enumname << " : " << number.getValue() << endl;
+            // else        cout << "    Updating enumeration " << enumname << " : " << number.getValue() << endl;
+            bitenum->setValue(number.getValue());
+        }
     }
 
     return status;
@@ -597,7 +1035,7 @@ bool IPXACTReader::parseEnumerations(const pugi::xml_node& elem, RegisterBitmap&
 
     for (xml_node current = elem.first_child(); current; current = current.next_sibling())
     {
-        if(string(current.name()) == "ipxact:enumeratedValue")
+        if(classify(current.name()) == TagEnumeratedValue)
         {
             bool parsed = parsseEnumeration(current, bitmap, update);
             status = status && parsed;
@@ -615,56 +1053,65 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
     int width = 0;
     string fieldname;
     string type;
-    Number *pResetValue = 0;
+    xml_node resetValue;
+    RegisterBitmap* bitmap = NULL;
+    bool found = false;
 
-    for (xml_node current = elem.first_child(); current; current = current.next_sibling())
+    // The field name leads the element, the bitfield is looked up once the
+    // first other element is reached.
+    for (xml_node current = elem.first_child(); ; current = current.next_sibling())
     {
-        if(string(current.name()) == "ipxact:name")
+        Tag tag = current ? classify(current.name()) : TagUnknown;
+        if(!found)
         {
-            if(current.child_value())
+            if(current && tag == TagName)
             {
-                fieldname = current.child_value();
+                if(current.child_value())
+                {
+                    fieldname = text(current.child_value());
+                }
+                else
+                {
+                    Diagnostics::error("Error: ipxact:name with no text.");
+                    status = false;
+                }
+                continue;
             }
-            else
+
+            // grab data struct
+            found = true;
+            bitmap = reg.get(fieldname);
+            if(!bitmap)
             {
-                cerr << "Error: ipxact:name with no text." << endl;
-                status = false;
+                if(update)
+                {
+                    Diagnostics::info("    **Bitfield %s not found, dropping.", fieldname.c_str());
+                }
+                else
+                {
+                    bitmap = mComponents.create<RegisterBitmap>(fieldname);
+                    reg.set(fieldname, bitmap);
+                }
             }
+            // if(!update) cout << "    Created bitfield "  << fieldname << endl;
+            // else        cout << "    Updating bitfield " << fieldname << endl;
         }
-    }
-
 
-    // grab data struct
-    RegisterBitmap* bitmap = reg.get(fieldname);
-    if(!bitmap)
-    {
-        if(update) 
-        {
-            cout << "    **Bitfield " << fieldname << " not found, dropping." << endl;
-        }
-        else
+        if(!current || !bitmap)
         {
-            bitmap = new RegisterBitmap(fieldname);
-            reg.set(fieldname, bitmap);
+            break;
         }
-    }
-    // Second pass.
-    if(bitmap)
-    {
-        // if(!update) cout << "    Created bitfield "  << fieldname << endl;
-        // else        cout << "    Updating bitfield " << fieldname << endl;
 
-        for (xml_node current = elem.first_child(); current; current = current.next_sibling())
+        switch(tag)
         {
-            if(string("ipxact:description") == current.name())
-            {
-                if(current.child_value())
+            case TagDescription:
+                if(sDescriptions && current.child_value())
                 {
-                    bitmap->setDescription(current.child_value());
+                    bitmap->setDescription(text(current.child_value()));
                 }
-            }
+                break;
 
-            if(string("ipxact:resets") == current.name())
+            case TagResets:
             {
                 xml_node pReset = current.child("ipxact:reset");
 
@@ -674,17 +1121,17 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
 
                     if(pResetValueElement && pResetValueElement.child_value())
                     {
-                        pResetValue = new Number(pResetValueElement.child_value());
+                        resetValue = pResetValueElement;
                     }
                 }
+                break;
             }
 
             // Assume the bit offset and width are correct from the source file.
-            if(string("ipxact:bitOffset") == current.name())
-            {
+            case TagBitOffset:
                 if(current.child_value())
                 {
-                    Number nstop(current.child_value());
+                    Number nstop(text(current.child_value()));
                     if(nstop.isValid())
                     {
                         stop = nstop.getValue();
@@ -692,18 +1139,18 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
                     else
                     {
                         status = false;
-                        cerr << "Error: ipxact:bitOffset with invalid text." << endl;
+                        Diagnostics::error("Error: ipxact:bitOffset with invalid text.");
                     }
                 }
-            }
+                break;
 
-            if(string("ipxact:vendorExtensions") == current.name())
+            case TagVendorExtensions:
             {
                 xml_node pReserved = current.child("reserved");
 
                 if(pReserved && pReserved.child_value())
                 {
-                    if(std::string("true") == pReserved.child_value())
+                    if(text(pReserved.child_value()) == "true")
                     {
                         bitmap->setReserved(true);
                     }
@@ -717,7 +1164,7 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
 
                 if(pConstantValue && pConstantValue.child_value())
                 {
-                    if(std::string("true") == pConstantValue.child_value())
+                    if(text(pConstantValue.child_value()) == "true")
                     {
                         bitmap->setConstantValue(true);
                     }
@@ -726,40 +1173,43 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
                         bitmap->setConstantValue(false);
                     }
                 }
+                break;
             }
 
-
-            if(string("ipxact:bitWidth") == current.name())
-            {
+            case TagBitWidth:
                 if(current.child_value())
                 {
-                    Number nwidth(current.child_value());
+                    Number nwidth(text(current.child_value()));
                     if(nwidth.isValid())
                     {
                         width = nwidth.getValue();
                     }
                     else
                     {
-                        cerr << "Error: ipxact:bitWidth with invalid text." << endl;
+                        Diagnostics::error("Error: ipxact:bitWidth with invalid text.");
                         status = false;
                     }
                 }
-            }
+                break;
 
-            if(string("ipxact:access") == current.name())
-            {
+            case TagAccess:
                 if(current.child_value())
                 {
-                    type = current.child_value();
+                    type = text(current.child_value());
                 }
-            }
+                break;
 
-            if(string("ipxact:enumeratedValues") == current.name())
-            {
+            case TagEnumeratedValues:
                 parseEnumerations(current, *bitmap, update);
-            }
+                break;
+
+            default:
+                break;
         }
+    }
 
+    if(bitmap)
+    {
         if(!update)
         {
             bitmap->setStart(stop + width - 1);
@@ -771,25 +1221,32 @@ bool IPXACTReader::parseRegisterBitmap(const pugi::xml_node& elem, Register& reg
             }
             else
             {
-                bitmap->setType(registerType(type));
+                bitmap->setType(registerType(type.c_str()));
             }
         }
 
-        if(status && pResetValue)
+        if(status && resetValue)
         {
-            if(pResetValue->getValue() != (pResetValue->getValue() &
-                (bitmap->getMask() >> bitmap->getStop())))
+            Number value(text(resetValue.child_value()));
+            bool fits = value.getValue() == (value.getValue() &
+                bitmap->getFieldMask());
+            for(unsigned int word = 1; word < value.getWords(); word++)
             {
-                cerr << "Reset value does not fit in field!" << endl;
+                fits = fits && !value.getValue(word);
+            }
+
+            if(!fits)
+            {
+                Diagnostics::error("Reset value does not fit in field!");
                 status = false;
             }
             else
             {
-                bitmap->setResetValue(pResetValue->getValue());
+                // x and z bits have no defined reset value.
+                uint64_t unknown = value.getXMask() | value.getZMask();
+                bitmap->setResetValue(value.getValue(),
+                    unknown & bitmap->getFieldMask());
             }
-
-            delete pResetValue;
-            pResetValue = 0;
         }
     }
 
@@ -45,7 +45,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#include <algorithm>
+
+#include <Diagnostics.hpp>
 #include <Reader.hpp>
 
 #include <IPXACTReader.hpp>
@@ -66,7 +73,7 @@ Reader* ReaderFactory::open(const char* filename, Components& components)
 		char* next = strtok_r(NULL, ".", &saveptr);
 		if(!next)
 		{
-			printf("Checking extension '%s'\n", partial);
+			Diagnostics::debug("Checking extension '%s'", partial);
 
 			     if(0 == strncmp("xml", partial, sizeof("xml"))) 		myReader = new IPXACTReader(filename, components);
 			else if(0 == strncmp("xhtml", partial, sizeof("xhtml"))) 	myReader = new XHTMLReader(filename, components);
@@ -75,18 +82,97 @@ Reader* ReaderFactory::open(const char* filename, Components& components)
 	} while(partial);
 
 	free(file);
-	printf("Reader: %p(%s)\n", myReader, filename);
+	Diagnostics::debug("Reader: %p(%s)", (void*)myReader, filename);
 	return myReader;
 }
 
 
+bool Reader::sDescriptions = true;
+
+void Reader::setDescriptions(bool descriptions)
+{
+	sDescriptions = descriptions;
+}
+
 Reader::Reader(const char* filename, Components& components) : mComponents(components)
-{    // Open output file
-    mFile.open(filename, ios::in | ios::binary);
+{    // Open input file
+    mFD = ::open(filename, O_RDONLY);
+    mData = NULL;
+    mSize = 0;
 }
 
 Reader::~Reader()
 {
-    mFile.close();
+    if(mData)
+    {
+        munmap(mData, mSize);
+    }
+
+    if(mFD >= 0)
+    {
+        close(mFD);
+    }
+}
+
+bool Reader::map(int protection)
+{
+    struct stat info;
+    if(mFD < 0 || fstat(mFD, &info) != 0 || info.st_size <= 0)
+    {
+        return false;
+    }
+
+    void* data = mmap(NULL, info.st_size, protection, MAP_PRIVATE, mFD, 0);
+    if(data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mData = (char*)data;
+    mSize = info.st_size;
+    return true;
+}
+
+char* Reader::mapFile(size_t& size)
+{
+    if(!mData && !map(PROT_READ | PROT_WRITE))
+    {
+        size = 0;
+        return NULL;
+    }
+
+    size = mSize;
+    return mData;
+}
+
+const char* Reader::viewFile(size_t& size)
+{
+    if(!mData && !map(PROT_READ))
+    {
+        size = 0;
+        return NULL;
+    }
 
+    size = mSize;
+    return mData;
+}
+
+string Reader::text(const char* value)
+{
+    string str(value ? value : "");
+    if(str.find('\n') != string::npos)
+    {
+        str.erase(std::remove(str.begin(), str.end(), '\n'), str.end());
+    }
+    return str;
+}
+
+void Reader::releaseFile(size_t offset)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    offset -= offset % page;
+    if(mData && offset && offset <= mSize)
+    {
+        madvise(mData, offset, MADV_DONTNEED);
+    }
 }
@@ -43,15 +43,18 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <XHTMLReader.hpp>
+#include <Diagnostics.hpp>
 #include <Number.hpp>
 
 #include <pugixml.hpp>
 #include <stdio.h>
 
+#include <atomic>
 #include <string>
 #include <cstring>
 #include <sstream>
 #include <algorithm>
+#include <thread>
 
 using namespace pugi;
 using namespace std;
@@ -59,14 +62,14 @@ using namespace std;
 // trim from start
 static inline std::string &ltrim(std::string &s) {
     s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-            std::not1(std::ptr_fun<int, int>(std::isspace))));
+            [](unsigned char c) { return !std::isspace(c); }));
     return s;
 }
 
 // trim from end
 static inline std::string &rtrim(std::string &s) {
     s.erase(std::find_if(s.rbegin(), s.rend(),
-            std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
+            [](unsigned char c) { return !std::isspace(c); }).base(), s.end());
     return s;
 }
 
@@ -87,59 +90,127 @@ XHTMLReader::~XHTMLReader()
 
 bool XHTMLReader::read()
 {
-    string tmp;
-    string xml;
-    while(std::getline(mFile, tmp)) {
-        xml += tmp;
-    }
+    XMLArena::Scope scope(mArena);
+    size_t size;
+    char* xml = mapFile(size);
 
     xml_document doc;
-    doc.load_string(xml.c_str());
+    if(xml)
+    {
+        doc.load_buffer_inplace(xml, size, pugi::parse_default);
+    }
 
     xml_node root = doc.document_element();
-    if(root)
+    if(!root)
+    {
+        return false;
+    }
+
+    parseElement(root);
+    return parseSections();
+}
+
+// Sections are parsed concurrently into private lists, then merged in file
+// order. A section updating a component defined by an earlier section is
+// parsed again into the shared list so the result matches a serial read.
+bool XHTMLReader::parseSections()
+{
+    optparse::Values& options = *gOptions;
+    int jobs = options.get("jobs");
+    bool parallel = jobs > 1 && mSections.size() > 1;
+
+    if(parallel)
     {
-        if(!parseElement(root))
+        atomic<size_t> next(0);
+        vector<thread> workers;
+        for(int i = 0; i < jobs && (size_t)i < mSections.size(); i++)
         {
-            return false;
+            workers.push_back(thread([&]() {
+                size_t index;
+                while((index = next++) < mSections.size())
+                {
+                    Section& section = mSections[index];
+                    string id = section.id;
+                    section.components = new Components();
+                    section.messages.start();
+                    section.status = addComponent(section.node, id, *section.components);
+                    section.messages.stop();
+                }
+            }));
+        }
+
+        for(size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
         }
     }
-    else
+
+    bool status = true;
+    for(size_t i = 0; i < mSections.size(); i++)
     {
-        return false;
+        Section& section = mSections[i];
+
+        bool independent = parallel;
+        if(parallel)
+        {
+            const vector<Component*>& list = section.components->get();
+            for(size_t j = 0; j < list.size(); j++)
+            {
+                if(list[j] && mComponents.get(list[j]->getNameSymbol()))
+                {
+                    independent = false;
+                }
+            }
+        }
+
+        if(independent)
+        {
+            section.messages.replay();
+            mComponents.adopt(section.components);
+        }
+        else
+        {
+            delete section.components;
+            section.status = addComponent(section.node, section.id, mComponents);
+        }
+        section.components = NULL;
+
+        status = status && section.status;
     }
 
-    return true;
+    mSections.clear();
+
+    return status;
 }
 
-bool XHTMLReader::parseElement(const pugi::xml_node& elem)
+// Collects the sections to parse.
+void XHTMLReader::parseElement(const pugi::xml_node& elem)
 {
-    bool status = true;
     // search for component block - ipxact:addressBlock
     const char* text = elem.value() ? elem.value() : "";
     const char* attr = elem.attribute("class").value();
     attr = attr ? attr : "";
 
-    cout << "Parsing block " << elem.name() << " : " << text << " : " << attr << endl;
+    Diagnostics::debug("Parsing block %s : %s : %s", elem.name(), text, attr);
 
     // TODO: parse ipxact:library for project name
 
     for (xml_node child = elem.first_child(); child; child = child.next_sibling())
     {
-        const char* id = child.attribute("id").value();
-        id = id ? id : "";
-        string idstr = id;
+        string idstr = Reader::text(child.attribute("id").value());
         // do something with each child element
         if(child.name() == string("section") &&
-            id != string(""))
+            !idstr.empty())
         {
             // parse registers
-            cout << "**********************" << endl;
-
-            if(!addComponent(child, idstr))
-            {
-                status = false;
-            }
+            Diagnostics::debug("**********************");
+
+            Section section;
+            section.node = child;
+            section.id = idstr;
+            section.components = NULL;
+            section.status = true;
+            mSections.push_back(section);
         }
         else if(child.name() == string("section"))
         {
@@ -148,14 +219,12 @@ bool XHTMLReader::parseElement(const pugi::xml_node& elem)
         }
         else
         {
-            status = status && parseElement(child);
+            parseElement(child);
         }
     }
-
-    return status;
 }
 
-bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component, int width)
+bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component, int width, Components& components)
 {
     bool ismii = false;
     if(component.getName() == "MII")
@@ -163,17 +232,16 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
         ismii = true;
     }
 
-    const char* childid = elem.attribute("id").value();
-    childid = childid ? childid : "";
+    string childid = text(elem.attribute("id").value());
 
-    size_t div = string(childid).find("-");
+    size_t div = childid.find("-");
     if(div == string::npos)
     {
         // Invalid id.
         return false;
     }
 
-    string addr = string(childid).substr(div+1, string::npos);
+    string addr = childid.substr(div+1, string::npos);
     uint64_t register_address = strtol(addr.c_str(), NULL, 16);
 
     // Grab register description
@@ -246,10 +314,10 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
             return false;
         }
 
-        cout << "\tID: " << childid << " at " << register_address << endl;
-        cout << "\t\tName: " << namestr << endl;
-        cout << "\t\tLong Name: " << desc << endl;
-        cout << "\t\tDesc: " << notestr << endl;
+        Diagnostics::debug("\tID: %s at %llu", childid.c_str(), (unsigned long long)register_address);
+        Diagnostics::debug("\t\tName: %s", namestr.c_str());
+        Diagnostics::debug("\t\tLong Name: %s", desc);
+        Diagnostics::debug("\t\tDesc: %s", notestr.c_str());
 
         if(ismii && string(desc) == "Miscellaneous Control")
         {
@@ -261,26 +329,26 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
             string(desc).find("[") == 0) // subcomponent
         {
             // TODO: FIXME
-            cout << "UNION... SKIPPING" << endl;
+            Diagnostics::info("UNION... SKIPPING");
             return true;
         }
         if(ismii &&
             (register_address & 0xFFFFF000) == 0xFFFFF000)
         {
-            cout << "PAGED REGISTER: SKIPPING" << endl;
+            Diagnostics::info("PAGED REGISTER: SKIPPING");
             return true;
         }
         if(ismii &&
             (register_address & 0xFFFFF000) == 0xFFFF0000)
         {
-            cout << "OTHER0 PAGED REGISTER: SKIPPING" << endl;
+            Diagnostics::info("OTHER0 PAGED REGISTER: SKIPPING");
             return true;
             // exit(-1);
         }
         if(ismii &&
             (register_address & 0xFFFFF000) == 0xFFFF1000)
         {
-            cout << "OTHER1 PAGED REGISTER: SKIPPING" << endl;
+            Diagnostics::info("OTHER1 PAGED REGISTER: SKIPPING");
             return true;
             // exit(-1);
         }
@@ -289,7 +357,7 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
         {
             if(string("") == desc)
             {
-                cerr << "Unknown name." << endl;
+                Diagnostics::error("Unknown name.");
                 exit(-1);
             }
             else
@@ -301,11 +369,14 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
         Register* reg = component.get(namestr);
         if(!reg)
         {
-            reg = new Register(namestr);
+            reg = components.create<Register>(namestr);
             component.set(namestr, reg);
         }
 
-        reg->setDescription(notestr);
+        if(sDescriptions)
+        {
+            reg->setDescription(notestr);
+        }
         reg->setWidth(width); // TODO
         reg->setAddr(register_address);
 
@@ -315,8 +386,8 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
             bits.attribute("class") &&
             bits.attribute("class").value() == string("bits"))
         {
-            cout << "\t\tHas bitfield." << endl;
-            if(!addBitmap(bits, *reg))
+            Diagnostics::debug("\t\tHas bitfield.");
+            if(!addBitmap(bits, *reg, components))
             {
                 return false;
             }
@@ -332,7 +403,7 @@ bool XHTMLReader::addRegister(const pugi::xml_node& elem, Component &component,
     return true;
 }
 
-bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg)
+bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg, Components& components)
 {
     int start;
     int stop;
@@ -362,7 +433,7 @@ bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg)
                 }
                 else
                 {
-                    cerr << "Unable to locate bit name" << endl;
+                    Diagnostics::error("Unable to locate bit name");
                     // Invalid
                     return false;
                 }
@@ -383,22 +454,23 @@ bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg)
                     start = stop = atoi(posstr);
                 }
 
+                string nm;
                 if(!bitname)
                 {
-                    string nm = "unknown_";
+                    nm = "unknown_";
                     nm += to_string(start);
                     nm += string("_");
                     nm += to_string(stop);
                     bitname = nm.c_str();
                 }
 
-                cout << "\t\t\t" << posstr << " : " << bitname <<  endl;
+                Diagnostics::debug("\t\t\t%s : %s", posstr, bitname);
 
                 // grab data struct
                 RegisterBitmap* bitmap = reg.get(bitname);
                 if(!bitmap)
                 {
-                    bitmap = new RegisterBitmap(bitname);
+                    bitmap = components.create<RegisterBitmap>(bitname);
                     reg.set(bitname, bitmap);
                 }
 
@@ -410,7 +482,7 @@ bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg)
                 xml_node enums = body.child("table"); // Second column is the description.
                 if(enums)
                 {
-                    addEnumerations(enums, *bitmap);
+                    addEnumerations(enums, *bitmap, components);
                 }
             }
         }
@@ -419,7 +491,7 @@ bool XHTMLReader::addBitmap(const pugi::xml_node& elem, Register &reg)
     return true;
 }
 
-bool XHTMLReader::addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bitmap)
+bool XHTMLReader::addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bitmap, Components& components)
 {
     int64_t val;
     for (xml_node current = elem.child("tr"); current; current = current.next_sibling("tr"))
@@ -449,12 +521,12 @@ bool XHTMLReader::addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bi
             {
                 return false;
             }
-            cout << "\t\t\t\t" << valuestr << " : " << namestr << endl;
+            Diagnostics::debug("\t\t\t\t%s : %s", valuestr, namestr);
             // grab data struct
             Enumeration* bitenum = bitmap.get(namestr);
             if(!bitenum)
             {
-                bitenum = new Enumeration(namestr);
+                bitenum = components.create<Enumeration>(namestr);
                 bitmap.set(namestr, bitenum);
             }
 
@@ -465,7 +537,7 @@ bool XHTMLReader::addEnumerations(const pugi::xml_node& elem, RegisterBitmap& bi
     return true;
 }
 
-bool XHTMLReader::addComponent(const pugi::xml_node& elem, std::string &id)
+bool XHTMLReader::addComponent(const pugi::xml_node& elem, std::string &id, Components& components)
 {
     int width = 32;
     int addressWidth = 8;
@@ -494,22 +566,25 @@ bool XHTMLReader::addComponent(const pugi::xml_node& elem, std::string &id)
     const char* desc = descelem.value();
     desc = desc ? desc : "";
 
-    cout << "Component: " << id <<  " : " << desc << endl;
+    Diagnostics::debug("Component: %s : %s", id.c_str(), desc);
 
-    Component* component = mComponents.get(id);
+    Component* component = components.get(id);
     if(!component)
     {
-        component = new Component(id);
-        mComponents.set(id, component);
+        component = components.create<Component>(id);
+        components.set(id, component);
     }
 
-    component->setDescription(desc);
+    if(sDescriptions)
+    {
+        component->setDescription(desc);
+    }
     component->setAddressUnitBits(addressWidth);
 
 
     for (xml_node current = elem.child("div"); current; current = current.next_sibling("div"))
     {
-        if(!addRegister(current, *component, width))
+        if(!addRegister(current, *component, width, components))
         {
             status = false;
         }
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       reader/XMLArena.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Arena allocator for pugixml documents.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <XMLArena.hpp>
+
+#include <pugixml.hpp>
+#include <stdint.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// pugixml allocates 32KiB pages, a chunk holds several of them.
+#define ARENA_CHUNK_SIZE    (256 * 1024)
+
+// Every block starts with a header telling where it came from, so blocks
+// are released correctly whichever arena is active when they are freed.
+#define ARENA_HEADER_SIZE   16
+#define ARENA_FROM_HEAP     0
+#define ARENA_FROM_ARENA    1
+
+static thread_local XMLArena* gArena = NULL;
+
+XMLArena::XMLArena() : mChunkSize(0), mUsed(0)
+{
+}
+
+XMLArena::~XMLArena()
+{
+    for(size_t i = 0; i < mChunks.size(); i++)
+    {
+        free(mChunks[i]);
+    }
+}
+
+void XMLArena::reset()
+{
+    // Chunks only grow, the last one is the largest.
+    for(size_t i = 0; i + 1 < mChunks.size(); i++)
+    {
+        free(mChunks[i]);
+    }
+
+    if(!mChunks.empty())
+    {
+        mChunks.erase(mChunks.begin(), mChunks.end() - 1);
+    }
+    mUsed = 0;
+}
+
+void* XMLArena::allocate(size_t size)
+{
+    size = (size + ARENA_HEADER_SIZE - 1) & ~(size_t)(ARENA_HEADER_SIZE - 1);
+    if(mChunks.empty() || mUsed + size > mChunkSize)
+    {
+        size_t chunkSize = mChunkSize ? mChunkSize : ARENA_CHUNK_SIZE;
+        while(chunkSize < size)
+        {
+            chunkSize *= 2;
+        }
+
+        char* chunk = (char*)malloc(chunkSize);
+        if(!chunk)
+        {
+            return NULL;
+        }
+
+        mChunks.push_back(chunk);
+        mChunkSize = chunkSize;
+        mUsed = 0;
+    }
+
+    void* block = mChunks.back() + mUsed;
+    mUsed += size;
+    return block;
+}
+
+void* XMLArena::pugiAllocate(size_t size)
+{
+    char* block;
+    uint64_t source;
+    if(gArena)
+    {
+        block = (char*)gArena->allocate(size + ARENA_HEADER_SIZE);
+        source = ARENA_FROM_ARENA;
+    }
+    else
+    {
+        block = (char*)malloc(size + ARENA_HEADER_SIZE);
+        source = ARENA_FROM_HEAP;
+    }
+
+    if(!block)
+    {
+        return NULL;
+    }
+
+    *(uint64_t*)block = source;
+    return block + ARENA_HEADER_SIZE;
+}
+
+void XMLArena::pugiDeallocate(void* ptr)
+{
+    char* block = (char*)ptr - ARENA_HEADER_SIZE;
+    if(*(uint64_t*)block == ARENA_FROM_HEAP)
+    {
+        free(block);
+    }
+}
+
+void XMLArena::install()
+{
+    pugi::set_memory_management_functions(pugiAllocate, pugiDeallocate);
+}
+
+XMLArena::Scope::Scope(XMLArena& arena) : mPrevious(gArena)
+{
+    gArena = &arena;
+}
+
+XMLArena::Scope::~Scope()
+{
+    gArena = mPrevious;
+}
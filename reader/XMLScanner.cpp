@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       reader/XMLScanner.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Minimal forward only XML tag scanner.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <XMLScanner.hpp>
+
+using namespace std;
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool starts_with(const char* pos, const char* end, const char* prefix)
+{
+    size_t length = strlen(prefix);
+    return (size_t)(end - pos) >= length && !memcmp(pos, prefix, length);
+}
+
+XMLScanner::XMLScanner(const char* begin, const char* end)
+{
+    mPos = begin;
+    mEnd = end;
+    mTag = begin;
+    mName = begin;
+    mNameLength = 0;
+}
+
+bool XMLScanner::skipPast(const char* from, const char* terminator)
+{
+    size_t length = strlen(terminator);
+    for(const char* p = from; p != mEnd; p++)
+    {
+        p = (const char*)memchr(p, terminator[0], mEnd - p);
+        if(!p)
+        {
+            break;
+        }
+
+        if(starts_with(p, mEnd, terminator))
+        {
+            mPos = p + length;
+            return true;
+        }
+    }
+
+    mPos = mEnd;
+    return false;
+}
+
+XMLScanner::Token XMLScanner::next()
+{
+    for(;;)
+    {
+        const char* tag = (const char*)memchr(mPos, '<', mEnd - mPos);
+        if(!tag)
+        {
+            mPos = mEnd;
+            return End;
+        }
+
+        mTag = tag;
+        const char* p = tag + 1;
+
+        if(starts_with(p, mEnd, "?"))
+        {
+            if(!skipPast(p, "?>")) return Error;
+            continue;
+        }
+
+        if(starts_with(p, mEnd, "!--"))
+        {
+            if(!skipPast(p + 3, "-->")) return Error;
+            continue;
+        }
+
+        if(starts_with(p, mEnd, "![CDATA["))
+        {
+            if(!skipPast(p, "]]>")) return Error;
+            continue;
+        }
+
+        if(starts_with(p, mEnd, "!"))
+        {
+            // DOCTYPE, possibly with an internal subset.
+            int brackets = 0;
+            for(; p != mEnd; p++)
+            {
+                if(*p == '[') brackets++;
+                else if(*p == ']') brackets--;
+                else if(*p == '>' && brackets <= 0) break;
+            }
+
+            if(p == mEnd) return Error;
+            mPos = p + 1;
+            continue;
+        }
+
+        bool endTag = starts_with(p, mEnd, "/");
+        if(endTag)
+        {
+            p++;
+        }
+
+        mName = p;
+        while(p != mEnd && !is_space(*p) && *p != '>' && *p != '/')
+        {
+            p++;
+        }
+        mNameLength = p - mName;
+        if(!mNameLength)
+        {
+            return Error;
+        }
+
+        // Attribute values may hold '>'.
+        while(p != mEnd && *p != '>')
+        {
+            if(*p == '"' || *p == '\'')
+            {
+                const char* quote = (const char*)memchr(p + 1, *p, mEnd - p - 1);
+                if(!quote) return Error;
+                p = quote;
+            }
+            p++;
+        }
+
+        if(p == mEnd)
+        {
+            return Error;
+        }
+
+        mPos = p + 1;
+        if(endTag)
+        {
+            return EndTag;
+        }
+
+        return (p[-1] == '/') ? EmptyTag : StartTag;
+    }
+}
+
+bool XMLScanner::skipElement()
+{
+    int depth = 1;
+    for(;;)
+    {
+        switch(next())
+        {
+            case StartTag:
+                depth++;
+                break;
+            case EndTag:
+                if(--depth == 0) return true;
+                break;
+            case EmptyTag:
+                break;
+            default:
+                return false;
+        }
+    }
+}
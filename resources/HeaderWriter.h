@@ -59,9 +59,11 @@ void init_<INIT_FUNCTION>(void);
 typedef CXXRegister<uint8_t,  0,  8> <GUARD>_uint8_t;
 typedef CXXRegister<uint16_t, 0, 16> <GUARD>_uint16_t;
 typedef CXXRegister<uint32_t, 0, 32> <GUARD>_uint32_t;
+typedef CXXRegister<uint64_t, 0, 64> <GUARD>_uint64_t;
 #define <GUARD>_uint8_t_bitfield(__pos__, __width__)  CXXRegister<uint8_t,  __pos__, __width__>
 #define <GUARD>_uint16_t_bitfield(__pos__, __width__) CXXRegister<uint16_t, __pos__, __width__>
 #define <GUARD>_uint32_t_bitfield(__pos__, __width__) CXXRegister<uint32_t, __pos__, __width__>
+#define <GUARD>_uint64_t_bitfield(__pos__, __width__) CXXRegister<uint64_t, __pos__, __width__>
 #define register_container struct
 #define <VOLATILE>
 #define BITFIELD_BEGIN(__type__, __name__) struct {
@@ -72,6 +74,7 @@ typedef CXXRegister<uint32_t, 0, 32> <GUARD>_uint32_t;
 typedef uint8_t  <GUARD>_uint8_t;
 typedef uint16_t <GUARD>_uint16_t;
 typedef uint32_t <GUARD>_uint32_t;
+typedef uint64_t <GUARD>_uint64_t;
 #define register_container union
 #define <VOLATILE> volatile
 #define BITFIELD_BEGIN(__type__, __name__) struct {
@@ -45,6 +45,8 @@
 #include <APESimulatorWriter.hpp>
 #include <Register.hpp>
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <Mangler.hpp>
 #include <string.h>
 #include <resources.h>
 
@@ -64,6 +66,13 @@ APESimulatorWriter::APESimulatorWriter(const char* filename) : Writer(filename)
     mIndent = 0;
 }
 
+// Writer for one component, with its own indentation.
+APESimulatorWriter::APESimulatorWriter(const APESimulatorWriter& parent) : Writer()
+{
+    mFilename = strdup(parent.mFilename);
+    mIndent = 0;
+}
+
 APESimulatorWriter::~APESimulatorWriter()
 {
     if(mFilename) free(mFilename);
@@ -104,8 +113,9 @@ std::string APESimulatorWriter::type(int width, bool isSigned) const
         case  8: regtype += "int8_t"; break;
         case 16: regtype += "int16_t"; break;
         case 32: regtype += "int32_t"; break;
+        case 64: regtype += "int64_t"; break;
         default:
-            fprintf(stderr, "Error: unable to handle a register width of %d, please use 8, 16, or 32.\n", width);
+            Diagnostics::error("Error: unable to handle a register width of %d, please use 8, 16, 32, or 64.", width);
             break;
     }
 
@@ -141,7 +151,7 @@ string APESimulatorWriter::serialize_bitmap_declaration(Component& component, Re
     if(isdigit(regname[0]))
     {
         newname = string("_") + newname;
-        cout << "Invalid: " << newname << endl;
+        Diagnostics::info("Invalid: %s", newname.c_str());
         // exit(-1);
     }
 
@@ -170,8 +180,8 @@ string APESimulatorWriter::serialize_register_definition(Component& component, R
 
     if(!reg.get().empty())
     {
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_iterator bits_it;
+        const std::vector<RegisterBitmap*>& bits = reg.get();
+        std::vector<RegisterBitmap*>::const_iterator bits_it;
         int width = reg.getWidth();
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
@@ -208,28 +218,45 @@ string APESimulatorWriter::serialize_register_ape_definition(Component& componen
     if(isdigit(regname[0]))
     {
         newname = string("_") + newname;
-        cout << "Invalid: " << newname << endl;
+        Diagnostics::info("Invalid: %s", newname.c_str());
         // exit(-1);
     }
 
 
-    int dim = reg.getDimensions();
-    if(dim > 1)
+    // Registers wider than 64 bits are an array of 64bit words.
+    int words = 1;
+    if(width > 64)
     {
-        string basename = string(component.getName()) + string(".") + newname + string("[i].r") + to_string(width);
-        decl << indent() << "for(int i = 0; i < " << dim << "; i++)" << endl;
-        decl << indent() << "{" << endl;
-        indent(1);
-        decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
-        decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
-        indent(-1);
-        decl << indent() << "}" << endl;
+        words = (width + 63) / 64;
+        width = 64;
     }
-    else
+
+    int dim = reg.getDimensions();
+    for(int word = 0; word < words; word++)
     {
-        string basename = string(component.getName()) + string(".") + newname + string(".r") + to_string(width);
-        decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
-        decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+        string wordname = string(".r") + to_string(width);
+        if(words > 1)
+        {
+            wordname += "[" + to_string(word) + "]";
+        }
+
+        if(dim > 1)
+        {
+            string basename = string(component.getName()) + string(".") + newname + string("[i]") + wordname;
+            decl << indent() << "for(int i = 0; i < " << dim << "; i++)" << endl;
+            decl << indent() << "{" << endl;
+            indent(1);
+            decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
+            decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+            indent(-1);
+            decl << indent() << "}" << endl;
+        }
+        else
+        {
+            string basename = string(component.getName()) + string(".") + newname + wordname;
+            decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
+            decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+        }
     }
 
     decl << endl;
@@ -240,83 +267,20 @@ string APESimulatorWriter::serialize_register_ape_definition(Component& componen
 
 string& APESimulatorWriter::escapeEnum(std::string& str)
 {
-    while(str.find(" ") != std::string::npos)
-    {
-        str.replace(str.find(" "), 1, ""); // Replace @'s with _AT_'s.
-    }
-
-    return escape(str);
+    str = Mangler::get(str, Mangler::Enumerator);
+    return str;
 }
 
 
 string& APESimulatorWriter::escape(std::string& str)
 {
-    std::replace(str.begin(), str.end(), ' ', '_'); // No spaces allowed
-    std::replace(str.begin(), str.end(), '-', '_'); // Replace -'s with _'s
-    std::replace(str.begin(), str.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(str.begin(), str.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(str.begin(), str.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(str.begin(), str.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(str.begin(), str.end(), ']', '_'); // Replace ]'s with _'s
-
-    while(str.find("—") != std::string::npos)
-    {
-        str.replace(str.find("—"), strlen("—"), "_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("@") != std::string::npos)
-    {
-        str.replace(str.find("@"), 1, "_AT_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("/") != std::string::npos)
-    {
-        str.replace(str.find("/"), 1, "_DIV_"); // Replace /'s with _DIV_'s.
-    }
-
+    str = Mangler::get(str, Mangler::Identifier);
     return str;
 }
 
 string APESimulatorWriter::camelcase(const string& str)
 {
-    string newstring = str;
-    std::replace(newstring.begin(), newstring.end(), ' ', '_'); // No spaces allowed
-    std::replace(newstring.begin(), newstring.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(newstring.begin(), newstring.end(), ']', '_'); // Replace ]'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '-', '_'); // Replace -'s with _'s
-
-    while(newstring.find("—") != std::string::npos)
-    {
-        newstring.replace(newstring.find("—"), strlen("—"), "_"); // Replace -'s with _'s.
-    }
-
-    ostringstream camelstr;
-    size_t srcpos = 0;
-    bool needscap = true;
-    for(srcpos = 0; srcpos < newstring.length(); srcpos++)
-    {
-        if(newstring[srcpos] == '_')
-        {
-            // do nothing, drop char.
-            needscap = true;
-        }
-        else
-        {
-            if(needscap)
-            {
-                camelstr << (char)toupper(newstring[srcpos]);
-            }
-            else
-            {
-                camelstr << (char)tolower(newstring[srcpos]);
-            }
-            needscap = false;
-        }
-    }
-    return camelstr.str();
+    return Mangler::get(str, Mangler::CamelCase);
 }
 
 std::string    APESimulatorWriter::serialize_component_declaration(Component& component)
@@ -324,8 +288,8 @@ std::string    APESimulatorWriter::serialize_component_declaration(Component& co
     const string& componentname = component.getName();
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
     decl << indent() << "/** @brief Component Registers for @ref " << componentname << ". */" << endl;
     for(it = regs.begin(); it != regs.end(); it++)
@@ -333,7 +297,6 @@ std::string    APESimulatorWriter::serialize_component_declaration(Component& co
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_definition(component, *reg);
         }
     }
@@ -346,8 +309,8 @@ std::string    APESimulatorWriter::serialize_ape_declaration(Component& componen
     const string& componentname = component.getName();
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
     decl << indent() << "/** @brief Component Registers for @ref " << componentname << ". */" << endl;
     for(it = regs.begin(); it != regs.end(); it++)
@@ -355,7 +318,6 @@ std::string    APESimulatorWriter::serialize_ape_declaration(Component& componen
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_ape_definition(component, *reg);
         }
     }
@@ -363,32 +325,14 @@ std::string    APESimulatorWriter::serialize_ape_declaration(Component& componen
     return decl.str();
 }
 
-void APESimulatorWriter::strreplace(string& origstr, const string& find, const string& replace)
+bool APESimulatorWriter::write(const CompiledModel& model)
 {
-    if(replace == find) return;
+    const Components& components = model.getComponents();
 
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool APESimulatorWriter::write(Components& components)
-{
-    bool status = true;
-
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
-    for(it = componentList.begin(); it != componentList.end(); it++)
-    {
-        Component* component = *it;
-        if(component)
-        {
-            status = status && writeComponent(*component);
-        }
-    }
-    return status;
+    return writeComponents(components, [this](Component& component) {
+        APESimulatorWriter writer(*this);
+        return writer.writeComponent(component);
+    });
 }
 
 
@@ -400,23 +344,28 @@ bool APESimulatorWriter::writeComponent(Component &component)
     string ape_filename = getComponentAPEFile(componentname.c_str());
 
 
-    string* file_contents = new RESOURCE_STRING(resources_SimulatorOutput_cpp);
-    string* ape_contents = new RESOURCE_STRING(resources_SimulatorOutput_ape_cpp);
+    static const Template file_template(RESOURCE_STRING(resources_SimulatorOutput_cpp));
+    static const Template ape_template(RESOURCE_STRING(resources_SimulatorOutput_ape_cpp));
     ostringstream base_addr;
     base_addr << "0x" << std::hex << (component.getBase());
 
     indent(1);
-    component.sort();
 
-    UpdateTemplate(*file_contents, filename, component);
-    strreplace(*file_contents, "<SERIALIZED>", serialize_component_declaration(component));
+    Template::Values values;
+    FillTemplate(values, filename, component);
+    values["SERIALIZED"] = serialize_component_declaration(component);
+
+    string file_contents;
+    file_template.render(values, file_contents);
 
-    UpdateTemplate(*ape_contents, ape_filename, component);
-    strreplace(*ape_contents, "<SERIALIZED>", serialize_ape_declaration(component));
+    FillTemplate(values, ape_filename, component);
+    values["SERIALIZED"] = serialize_ape_declaration(component);
+    values["BASE_ADDR"] = base_addr.str();
 
-    strreplace(*ape_contents, "<BASE_ADDR>", base_addr.str());
+    string ape_contents;
+    ape_template.render(values, ape_contents);
 
 
     indent(-1);
-    return WriteToFile(filename, *file_contents) && WriteToFile(ape_filename, *ape_contents);
+    return WriteToFile(filename, file_contents) && WriteToFile(ape_filename, ape_contents);
 }
@@ -45,6 +45,8 @@
 #include <ASMWriter.hpp>
 #include <Register.hpp>
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <Mangler.hpp>
 #include <string.h>
 #include <resources.h>
 
@@ -80,8 +82,9 @@ std::string ASMWriter::type(int width, bool isSigned) const
         case  8: regtype += "Int8"; break;
         case 16: regtype += "Int16"; break;
         case 32: regtype += "Int32"; break;
+        case 64: regtype += "Int64"; break;
         default:
-            fprintf(stderr, "Error: unable to handle a register width of %d, please use 8, 16, or 32.\n", width);
+            Diagnostics::error("Error: unable to handle a register width of %d, please use 8, 16, 32, or 64.", width);
             break;
     }
 
@@ -99,12 +102,12 @@ std::string ASMWriter::indent(int modifier)
     return indent.str();
 }
 
-string ASMWriter::serialize_enum_definition(Component& component, Register& reg, RegisterBitmap& bitmap, Enumeration& thisenum)
+string ASMWriter::serialize_enum_definition(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, size_t thisenum)
 {
-    string enumname = thisenum.getName();
-    string bitmapname = bitmap.getName();
-    string regname = reg.getName();
-    string componentname = component.getName();
+    string enumname = model.getEnumerationName(thisenum);
+    string bitmapname = model.getFieldName(bitmap);
+    string regname = model.getRegisterName(reg);
+    string componentname = model.getComponentName(component);
 
     escape(enumname);
     escape(bitmapname);
@@ -118,17 +121,17 @@ string ASMWriter::serialize_enum_definition(Component& component, Register& reg,
 
     ostringstream decl;
 
-    decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_" << enumname << ", 0x" << std::hex << thisenum.getValue() << endl;
+    decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_" << enumname << ", 0x" << std::hex << model.getEnumerationValue(thisenum) << endl;
 
     return decl.str();
 }
 
 
-string ASMWriter::serialize_bitmap_definition(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth)
+string ASMWriter::serialize_bitmap_definition(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, int regwidth)
 {
-    string bitmapname    = bitmap.getName();
-    string regname       = reg.getName();
-    string componentname = component.getName();
+    string bitmapname    = model.getFieldName(bitmap);
+    string regname       = model.getRegisterName(reg);
+    string componentname = model.getComponentName(component);
 
     escape(bitmapname);
     escape(regname);
@@ -139,29 +142,29 @@ string ASMWriter::serialize_bitmap_definition(Component& component, Register& re
     std::transform(regname.begin(),       regname.end(),       regname.begin(),       ::toupper);
     std::transform(componentname.begin(), componentname.end(), componentname.begin(), ::toupper);
 
-    int mask = 0;
-    for(int i = bitmap.getStop(); i <= bitmap.getStart(); i++)
+    ostringstream decl;
+    decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_SHIFT, " << model.getFieldStop(bitmap) << endl;
+
+    unsigned int words = model.getFieldWords(bitmap);
+    if(words == 1)
     {
-        mask |= 1 << i;
+        decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_MASK,  0x" << std::hex << model.getFieldMask(bitmap) << endl;
+    }
+    else
+    {
+        // Fields above bit 63 get a mask for each 64bit word they cover.
+        for(unsigned int word = model.getFieldStop(bitmap) / 64; word < words; word++)
+        {
+            decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_MASK_" << std::dec << word << ",  0x" << std::hex << model.getFieldMask(bitmap, word) << endl;
+        }
     }
 
-
-    ostringstream decl;
-    decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_SHIFT, " << bitmap.getStop() << endl;
-    decl << ".equ        " << componentname << "_" << regname << "_" << bitmapname << "_MASK,  0x" << std::hex << mask << endl;
-
-    if(!bitmap.get().empty())
+    const CompiledModel::Range& enums = model.getFieldEnumerations(bitmap);
+    if(!enums.empty())
     {
-        const std::list<Enumeration*>& bits = bitmap.get();
-        std::list<Enumeration*>::const_iterator bits_it;
-        for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
+        for(size_t thisenum = enums.begin(); thisenum != enums.end(); thisenum++)
         {
-            Enumeration* thisenum = *bits_it;
-            if(thisenum)
-            {
-                thisenum->sort();
-                decl << serialize_enum_definition(component, reg, bitmap, *thisenum);
-            }
+            decl << serialize_enum_definition(model, component, reg, bitmap, thisenum);
         }
 
          decl << endl;
@@ -171,45 +174,38 @@ string ASMWriter::serialize_bitmap_definition(Component& component, Register& re
     return decl.str();
 }
 
-string ASMWriter::serialize_bitmap_declaration(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth)
+string ASMWriter::serialize_bitmap_declaration(const CompiledModel& model, size_t component, size_t reg, size_t bitmap, int regwidth)
 {
     ostringstream decl;
 
     return decl.str();
 }
 
-string ASMWriter::serialize_register_definition(Component& component, Register& reg)
+string ASMWriter::serialize_register_definition(const CompiledModel& model, size_t component, size_t reg)
 {
-    string regname = reg.getName();
-    string componentname = component.getName();
+    string regname = model.getRegisterName(reg);
+    string componentname = model.getComponentName(component);
+    const string& description = model.getRegisterDescription(reg);
+    uint64_t address = model.getComponentBase(component) + model.getRegisterAddr(reg);
 
     std::transform(regname.begin(),       regname.end(),       regname.begin(),       ::toupper);
     std::transform(componentname.begin(), componentname.end(), componentname.begin(), ::toupper);
 
     ostringstream decl;
-    if(!reg.getDescription().empty())
+    if(!description.empty())
     {
-        decl <<  ".equ    REG_" << componentname << "_" << regname << ", 0x" << std::hex << component.getBase() + reg.getAddr() << " ; " << reg.getDescription() << endl;        
+        decl <<  ".equ    REG_" << componentname << "_" << regname << ", 0x" << std::hex << address << " ; " << description << endl;
     }
     else
     {
-        decl <<  ".equ    REG_" << componentname << "_" << regname << ", 0x" << std::hex << component.getBase() + reg.getAddr() << endl;
+        decl <<  ".equ    REG_" << componentname << "_" << regname << ", 0x" << std::hex << address << endl;
     }
 
 
-    if(!reg.get().empty())
+    const CompiledModel::Range& bits = model.getRegisterFields(reg);
+    for(size_t bit = bits.begin(); bit != bits.end(); bit++)
     {
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_iterator bits_it;
-        for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
-        {
-            RegisterBitmap* bit = *bits_it;
-            if(bit)
-            {
-                bit->sort();
-                decl << serialize_bitmap_definition(component, reg, *bit, reg.getWidth());
-            }
-        }
+        decl << serialize_bitmap_definition(model, component, reg, bit, model.getRegisterWidth(reg));
     }
     decl << endl;
 
@@ -218,55 +214,16 @@ string ASMWriter::serialize_register_definition(Component& component, Register&
 
 string ASMWriter::camelcase(const string& str)
 {
-    ostringstream camelstr;
-    size_t srcpos = 0;
-    bool needscap = true;
-    for(srcpos = 0; srcpos < str.length(); srcpos++)
-    {
-        if(str[srcpos] == '_')
-        {
-            // do nothing, drop char.
-            needscap = true;
-        }
-        else
-        {
-            if(needscap)
-            {
-                camelstr << (char)toupper(str[srcpos]);
-            }
-            else
-            {
-                camelstr << (char)tolower(str[srcpos]);
-            }
-            needscap = false;
-        }
-    }
-    return camelstr.str();
+    return Mangler::get(str, Mangler::Capitalized);
 }
 
 string& ASMWriter::escape(std::string& str)
 {
-    std::replace(str.begin(), str.end(), ' ', '_'); // No spaces allowed
-    std::replace(str.begin(), str.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(str.begin(), str.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(str.begin(), str.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(str.begin(), str.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(str.begin(), str.end(), ']', '_'); // Replace ]'s with _'s
-
-    while(str.find("@") != std::string::npos)
-    {
-        str.replace(str.find("@"), 1, "_AT_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("/") != std::string::npos)
-    {
-        str.replace(str.find("/"), 1, "_DIV_"); // Replace /'s with _DIV_'s.
-    }
-
+    str = Mangler::get(str, Mangler::Assembler);
     return str;
 }
 
-string ASMWriter::serialize_register_declaration(Component& component, Register& reg)
+string ASMWriter::serialize_register_declaration(const CompiledModel& model, size_t component, size_t reg)
 {
     ostringstream decl;
     
@@ -274,59 +231,38 @@ string ASMWriter::serialize_register_declaration(Component& component, Register&
     return decl.str();
 }
 
-std::string    ASMWriter::serialize_component_declaration(Component& component)
+std::string    ASMWriter::serialize_component_declaration(const CompiledModel& model, size_t component)
 {
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
-
-    for(it = regs.begin(); it != regs.end(); it++)
+    const CompiledModel::Range& regs = model.getComponentRegisters(component);
+    for(size_t reg = regs.begin(); reg != regs.end(); reg++)
     {
-        Register* reg = *it;
-        if(reg)
-        {
-            reg->sort();
-            decl << serialize_register_definition(component, *reg);
-        }
+        decl << serialize_register_definition(model, component, reg);
     }
 
     return decl.str();
 }
 
-void ASMWriter::strreplace(string& origstr, const string& find, const string& replace)
-{
-    if(replace == find) return;
-
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool ASMWriter::write(Components& components)
+bool ASMWriter::write(const CompiledModel& model)
 {
     string filename(mFilename);
     ostringstream output;
-    string* file_contents = new RESOURCE_STRING(resources_ASMHeader_s);
+    static const Template file_template(RESOURCE_STRING(resources_ASMHeader_s));
 
     indent(1);
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
-    for(it = componentList.begin(); it != componentList.end(); it++)
+    for(size_t component = 0; component < model.getComponentCount(); component++)
     {
-        Component* component = *it;
-        if(component) 
-        {
-            component->sort();
-            output << serialize_component_declaration(*component);
-            output << endl;
-        }
+        output << serialize_component_declaration(model, component);
+        output << endl;
     }
 
-    UpdateTemplate(*file_contents, filename);
-    strreplace(*file_contents, "<SERIALIZED>", output.str());
+    Template::Values values;
+    FillTemplate(values, filename);
+    values["SERIALIZED"] = output.str();
 
-    return WriteToFile(filename, *file_contents);
+    string file_contents;
+    file_template.render(values, file_contents);
+    mFile << file_contents;
+    return true;
 }
@@ -63,73 +63,57 @@ ASMSymbols::~ASMSymbols()
     if(mFilename) free(mFilename);
 }
 
-std::string ASMSymbols::serialize_component_declaration(Component& component)
+std::string ASMSymbols::serialize_component_declaration(const CompiledModel& model, size_t component)
 {
     ostringstream decl;
 
-    string componentname = component.getName();
+    string componentname = model.getComponentName(component);
     std::transform(componentname.begin(), componentname.end(), componentname.begin(), ::toupper);
 
 	int size = 0;
-    if(component.getRange())
+    if(model.getComponentRange(component))
     {
-        size = component.getRange();
+        size = model.getComponentRange(component);
     }
     else
     {
-        if(!component.get().empty())
+        const CompiledModel::Range& regs = model.getComponentRegisters(component);
+        if(!regs.empty())
         {
-            Register* lastreg = component.get().back();
-            if(lastreg)
-            {
-                int endwidth = lastreg->getWidth();
-                int endaddr = lastreg->getAddr();
-                int dims = lastreg->getDimensions();
+            size_t lastreg = regs.end() - 1;
+            int endwidth = model.getRegisterWidth(lastreg);
+            int endaddr = model.getRegisterAddr(lastreg);
+            int dims = model.getRegisterDimensions(lastreg);
 
-                size = (dims * (endwidth/8)) + endaddr;
-            }
+            size = (dims * (endwidth/8)) + endaddr;
         }
     }
 
     decl << ".global " << componentname << endl;
-    decl << ".equ    " << componentname << ", 0x" << std::hex << component.getBase() << endl;
+    decl << ".equ    " << componentname << ", 0x" << std::hex << model.getComponentBase(component) << endl;
     decl << ".size   " << componentname << ", 0x" << std::hex << size << endl;
 
     return decl.str();
 }
 
-void ASMSymbols::strreplace(string& origstr, const string& find, const string& replace)
-{
-    if(replace == find) return;
-
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool ASMSymbols::write(Components& components)
+bool ASMSymbols::write(const CompiledModel& model)
 {
     string filename(mFilename);
     ostringstream output;
-    string* file_contents = new RESOURCE_STRING(resources_ASMSymbols_s);
+    static const Template file_template(RESOURCE_STRING(resources_ASMSymbols_s));
 
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
-    for(it = componentList.begin(); it != componentList.end(); it++)
+    for(size_t component = 0; component < model.getComponentCount(); component++)
     {
-        Component* component = *it;
-        if(component)
-        {
-            component->sort();
-            output << serialize_component_declaration(*component);
-            output << endl;
-        }
+        output << serialize_component_declaration(model, component);
+        output << endl;
     }
 
-    UpdateTemplate(*file_contents, filename);
-    strreplace(*file_contents, "<SERIALIZED>", output.str());
+    Template::Values values;
+    FillTemplate(values, filename);
+    values["SERIALIZED"] = output.str();
 
-    return WriteToFile(filename, *file_contents);
+    string file_contents;
+    file_template.render(values, file_contents);
+    mFile << file_contents;
+    return true;
 }
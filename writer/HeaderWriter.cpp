@@ -45,6 +45,8 @@
 #include <HeaderWriter.hpp>
 #include <Register.hpp>
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <Mangler.hpp>
 #include <string.h>
 #include <resources.h>
 
@@ -64,6 +66,13 @@ HeaderWriter::HeaderWriter(const char* filename) : Writer(filename)
     mIndent = 0;
 }
 
+// Writer for one component file, with its own indentation.
+HeaderWriter::HeaderWriter(const std::string& filename) : Writer()
+{
+    mFilename = strdup(filename.c_str());
+    mIndent = 0;
+}
+
 HeaderWriter::~HeaderWriter()
 {
     if(mFilename) free(mFilename);
@@ -102,6 +111,24 @@ std::string HeaderWriter::get_type_name(Component& component, Register& reg)
     return reg_type;
 }
 
+// Suffix for integer literals, values above 32bits need a 64bit type.
+static const char* literal_suffix(uint64_t value)
+{
+    return (value >> 32) ? "ull" : "u";
+}
+
+// Width of the storage words used for a register, registers wider than 64
+// bits are accessed as arrays of 64bit words.
+static int word_width(int width)
+{
+    return width > 64 ? 64 : width;
+}
+
+static int word_count(int width)
+{
+    return width > 64 ? (width + 63) / 64 : 1;
+}
+
 std::string HeaderWriter::type(int width, bool isSigned) const
 {
 
@@ -124,8 +151,9 @@ std::string HeaderWriter::type(int width, bool isSigned) const
         case  8: regtype += "int8_t"; break;
         case 16: regtype += "int16_t"; break;
         case 32: regtype += "int32_t"; break;
+        case 64: regtype += "int64_t"; break;
         default:
-            fprintf(stderr, "Error: unable to handle a register width of %d, please use 8, 16, or 32.\n", width);
+            Diagnostics::error("Error: unable to handle a register width of %d, please use 8, 16, 32, or 64.", width);
             break;
     }
 
@@ -176,13 +204,20 @@ string HeaderWriter::serialize_enum_definition(Component& component, Register& r
 
     ostringstream decl;
 
-    decl << "#define     " << componentname << "_" << regname << "_" << bitmapname << "_" << enumname << " 0x" << std::hex << thisenum.getValue() << "u" << endl;
+    decl << "#define     " << componentname << "_" << regname << "_" << bitmapname << "_" << enumname << " 0x" << std::hex << thisenum.getValue() << literal_suffix(thisenum.getValue()) << endl;
 
     return decl.str();
 }
 
 string HeaderWriter::serialize_bitmap_definition(Component& component, Register& reg, RegisterBitmap& bitmap, int regwidth)
 {
+    if(bitmap.getStart() > 63)
+    {
+        Diagnostics::warning("Warning: field '%s' of register '%s' is above bit 63, no access macros generated.",
+            bitmap.getName().c_str(), reg.getName().c_str());
+        return "";
+    }
+
     string bitmapname    = bitmap.getName();
     string regname       = reg.getName();
     string componentname = component.getName();
@@ -196,29 +231,24 @@ string HeaderWriter::serialize_bitmap_definition(Component& component, Register&
     std::transform(regname.begin(),       regname.end(),       regname.begin(),       ::toupper);
     std::transform(componentname.begin(), componentname.end(), componentname.begin(), ::toupper);
 
-    int mask = 0;
-    for(int i = bitmap.getStop(); i <= bitmap.getStart(); i++)
-    {
-        mask |= 1 << i;
-    }
+    uint64_t mask = bitmap.getMask();
 
 
     ostringstream decl;
     decl << "#define     " << componentname << "_" << regname << "_" << bitmapname << "_SHIFT " << bitmap.getStop() << "u" << endl;
-    decl << "#define     " << componentname << "_" << regname << "_" << bitmapname << "_MASK  0x" << std::hex << mask << "u" << endl;
+    decl << "#define     " << componentname << "_" << regname << "_" << bitmapname << "_MASK  0x" << std::hex << mask << literal_suffix(mask) << endl;
     decl << "#define GET_" << componentname << "_" << regname << "_" << bitmapname << "(__reg__)  (((__reg__) & 0x" << std::hex << mask << ") >> " << std::dec << bitmap.getStop() << "u)" << endl;
-    decl << "#define SET_" << componentname << "_" << regname << "_" << bitmapname << "(__val__)  (((__val__) << "  << std::dec << bitmap.getStop() << "u) & 0x" << std::hex << mask << "u)" << endl;
+    decl << "#define SET_" << componentname << "_" << regname << "_" << bitmapname << "(__val__)  (((__val__) << "  << std::dec << bitmap.getStop() << "u) & 0x" << std::hex << mask << literal_suffix(mask) << ")" << endl;
 
     if(!bitmap.get().empty())
     {
-        const std::list<Enumeration*>& bits = bitmap.get();
-        std::list<Enumeration*>::const_iterator bits_it;
+        const std::vector<Enumeration*>& bits = bitmap.get();
+        std::vector<Enumeration*>::const_iterator bits_it;
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
             Enumeration* thisenum = *bits_it;
             if(thisenum)
             {
-                thisenum->sort();
                 decl << serialize_enum_definition(component, reg, bitmap, *thisenum);
             }
         }
@@ -259,14 +289,14 @@ string HeaderWriter::serialize_bitmap_declaration(Component& component, Register
 }
 
 #if 0
-static int getExpectedWidth(RegisterBitmap& bit, std::list<RegisterBitmap*>::const_iterator& next, const std::list<RegisterBitmap*>& bits)
+static int getExpectedWidth(RegisterBitmap& bit, std::vector<RegisterBitmap*>::const_iterator& next, const std::vector<RegisterBitmap*>& bits)
 {
     int base_bit = bit.getStop();
     int end_bit  = bit.getStart() + 1;
     int minWidth = end_bit - base_bit;
     int width;
     // We are at a byte boundary, see if all of the bitfields fit in an 8bit value.
-    std::list<RegisterBitmap*>::const_iterator bits_next = next;
+    std::vector<RegisterBitmap*>::const_iterator bits_next = next;
     bits_next++;
     for(; bits_next != bits.end(); bits_next++)
     {
@@ -309,7 +339,7 @@ static int getExpectedWidth(RegisterBitmap& bit, std::list<RegisterBitmap*>::con
                             return max_width;
                         }
 
-                        printf("splitting reserved to width %d for bitfield %s\n", width, bit.getName().c_str());
+                        Diagnostics::debug("splitting reserved to width %d for bitfield %s", width, bit.getName().c_str());
                         return width;
                     }
                 }
@@ -326,13 +356,13 @@ static int getExpectedWidth(RegisterBitmap& bit, std::list<RegisterBitmap*>::con
     return width;
 }
 
-static int getNextExpectedWidth(RegisterBitmap& bit, std::list<RegisterBitmap*>::const_iterator& next, const std::list<RegisterBitmap*>& bits)
+static int getNextExpectedWidth(RegisterBitmap& bit, std::vector<RegisterBitmap*>::const_iterator& next, const std::vector<RegisterBitmap*>& bits)
 {
     //int base_bit = bit.getStop();
     int base_bit = 0;
 
     // We are at a byte boundary, see if all of the bitfields fit in an 8bit value.
-    std::list<RegisterBitmap*>::const_iterator bits_next = next;
+    std::vector<RegisterBitmap*>::const_iterator bits_next = next;
     bits_next++;
     for(; bits_next != bits.end(); bits_next++)
     {
@@ -376,17 +406,16 @@ string HeaderWriter::serialize_bitmap_constructor(Component& component, Register
 
     if(!bitmap.get().empty())
     {
-        const std::list<Enumeration*>& bits = bitmap.get();
-        std::list<Enumeration*>::const_iterator bits_it;
+        const std::vector<Enumeration*>& bits = bitmap.get();
+        std::vector<Enumeration*>::const_iterator bits_it;
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
             Enumeration* thisenum = *bits_it;
             if(thisenum)
             {
-                thisenum->sort();
 
                 string enumname = (*thisenum).getName();
-                int value = (*thisenum).getValue();
+                uint64_t value = (*thisenum).getValue();
 
                 decl << indent() << bitvar << ".addEnum(\"" << enumname << "\", 0x" << std::hex << value << ");" << endl;
 
@@ -418,8 +447,8 @@ string HeaderWriter::serialize_register_constructor(Component& component, Regist
 
     if(!reg.get().empty())
     {
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_iterator bits_it;
+        const std::vector<RegisterBitmap*>& bits = reg.get();
+        std::vector<RegisterBitmap*>::const_iterator bits_it;
         int width = reg.getWidth();
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
@@ -452,7 +481,7 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
             width = reg.getWidth();//getExpectedWidth(*bit, bits_it, bits);
             if(width % 8)
             {
-                fprintf(stdout, "Warning: %s has an unexpected bit width of %d.\n", (*bit).getName().c_str(), width);
+                Diagnostics::warning("Warning: %s has an unexpected bit width of %d.", (*bit).getName().c_str(), width);
 
                 // Bitfield has missing bits.
                 width += (8 - width % 8);
@@ -460,7 +489,7 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
 
             if(nextWidth == 24 || (nextWidth == 16 && base_bit == 0 && width == 8))
             {
-                fprintf(stdout, "Warning: converting 8bit field  %s to 32bit due to next entry requiring 24bits.\n", (*bit).getName().c_str());
+                Diagnostics::warning("Warning: converting 8bit field  %s to 32bit due to next entry requiring 24bits.", (*bit).getName().c_str());
                 width = 32;
             }
 
@@ -468,7 +497,7 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
             {
                 if(base_bit > 8) // promote due to above. next expected width
                 {
-                    fprintf(stdout, "Error: unexpected promotion of 24bit field %s to 32bits.\n", (*bit).getName().c_str());
+                    Diagnostics::error("Error: unexpected promotion of 24bit field %s to 32bits.", (*bit).getName().c_str());
                 }
                 width = 32; // 24bit width not allowed, convert to 32.
             }
@@ -483,24 +512,26 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
 
             if(width == 0)
             {
-                fprintf(stdout, "%s.%s.%s start bit is %d, end is %d.\n",
+                Diagnostics::info("%s.%s.%s start bit is %d, end is %d.",
                     componentname.c_str(), writer.camelcase(regname).c_str(), (*bit).getName().c_str(), base_bit, bit->getStart() + 1);
                 width = 32;
             }
         }
 
         // width = 32;
-        bit->sort();
         if(width <= bit->getStart() - bit->getStop())
         {
-            fprintf(stdout, "Warning: bitfield  %s has an expected width of %d.\n", (*bit).getName().c_str(), width);
+            Diagnostics::warning("Warning: bitfield  %s has an expected width of %d.", (*bit).getName().c_str(), width);
 
-            // split the register into two or more.
-            std::string origName = bit->getName();
+            // split the register into two or more. The parts are written
+            // from a local bitmap, the model's bitmap may be shared.
+            RegisterBitmap part(bit->getName());
+            part.setDescription(bit->getDescription());
             int actualStart = bit->getStart();
             int actualStop = bit->getStop();
             int actualWidth = actualStart - bit->getStop();
             int currentBit = 0;
+            part.setStop(actualStop);
             while(currentBit < actualWidth)
             {
                 ostringstream name;
@@ -512,20 +543,17 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
                 {
                     currentStop = actualStart + 1;
                 }
-                bit->setStart(currentStop - 1);
+                part.setStart(currentStop - 1);
 
-                name << "reserved" << "_" << std::dec << (int)bit->getStart() << "_" << (int)bit->getStop();
+                name << "reserved" << "_" << std::dec << (int)part.getStart() << "_" << (int)part.getStop();
 
-                bit->setName(name.str());
+                part.setName(name.str());
 
-                decl << writer.serialize_bitmap_declaration(component, reg, *bit, width);
+                decl << writer.serialize_bitmap_declaration(component, reg, part, width);
 
                 // set next start.
-                bit->setStop(currentStop);
+                part.setStop(currentStop);
             }
-            bit->setName(origName);
-            bit->setStart(actualStart);
-            bit->setStop(actualStop);
         }
         else
         {
@@ -550,8 +578,8 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
                     ostringstream name;
                     // Pad out to the needed position
                     name << "reserved" << "_" << std::dec << newStart << "_" << currentStop;
-                    cout << "Adding padding " << name.str() << "(width: " << width << ")" << endl;
-                    cout << "Error: " << bit->getName() << " bit position gap: " << newStart << " to " << currentStop << endl;
+                    Diagnostics::debug("Adding padding %s(width: %d)", name.str().c_str(), width);
+                    Diagnostics::debug("%s bit position gap: %d to %d", bit->getName().c_str(), newStart, currentStop);
                     // exit(-1);
                     // RegisterBitmap padding(name.str());
                     padding.setName(name.str());
@@ -565,7 +593,7 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
                 }
                 if(loops > 1)
                 {
-                    cout << "reduced." << endl;
+                    Diagnostics::debug("reduced.");
                     // /exit(-1);
                 }
             }
@@ -573,7 +601,7 @@ static string convert_single_bitmap(HeaderWriter& writer, Component& component,
         }
 
         prev_position = bit->getStart() + 1;
-        cout << "Wrote bit " << bit->getName() << " from " << bit->getStart() << " to " << bit->getStop() << endl;
+        Diagnostics::debug("Wrote bit %s from %d to %d", bit->getName().c_str(), (int)bit->getStart(), (int)bit->getStop());
     }
     return decl.str();;
 }
@@ -591,20 +619,19 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
 
     ostringstream decl;
     string defregname = regname;
-    decl <<  "#define REG_" << componentname << "_" << escape(defregname) << " ((" << get_volatile() << " " << type(reg.getWidth(), false) << "*)0x" << std::hex << (component.getBase() + reg.getAddr()) << ") /* " << reg.getDescription() << " */" << endl;
+    decl <<  "#define REG_" << componentname << "_" << escape(defregname) << " ((" << get_volatile() << " " << type(word_width(reg.getWidth()), false) << "*)0x" << std::hex << (component.getBase() + reg.getAddr()) << ") /* " << reg.getDescription() << " */" << endl;
 
     if(!(component.isTypeIDCopy() || reg.isTypeIDCopy()))
     {
         if(!reg.get().empty())
         {
-            const std::list<RegisterBitmap*>& bits = reg.get();
-            std::list<RegisterBitmap*>::const_iterator bits_it;
+            const std::vector<RegisterBitmap*>& bits = reg.get();
+            std::vector<RegisterBitmap*>::const_iterator bits_it;
             for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
             {
                 RegisterBitmap* bit = *bits_it;
                 if(bit)
                 {
-                    bit->sort();
                     decl << serialize_bitmap_definition(component, reg, *bit, reg.getWidth());
                 }
             }
@@ -616,13 +643,13 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
         decl << indent() << "typedef register_container " << registerType << " {" << endl;
         indent(1);
 
-        int i = width;
+        int i = word_width(width);
         while(i > 0)
         {
             decl << indent() << "/** @brief " << std::dec << i << "bit direct register access. */" << endl;
-            if(width / i > 1)
+            if(word_count(width) > 1)
             {
-                decl << indent() << type(i, false) << " r" << std::dec << i << "[" << width / i << "];" << endl;
+                decl << indent() << type(i, false) << " r" << std::dec << i << "[" << word_count(width) << "];" << endl;
             }
             else
             {
@@ -634,7 +661,9 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
             i = 0;
         }
 
-        if(!reg.get().empty())
+        // Bitfields can't be wider than their 64bit storage type, wide
+        // registers are only accessible as an array of words.
+        if(!reg.get().empty() && width <= 64)
         {
             decl << endl;
             // decl << indent()  <<"struct {" << endl;
@@ -643,8 +672,8 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
 
             indent(1);
 
-            const std::list<RegisterBitmap*>& bits = reg.get();
-            std::list<RegisterBitmap*>::const_iterator bits_it;
+            const std::vector<RegisterBitmap*>& bits = reg.get();
+            std::vector<RegisterBitmap*>::const_iterator bits_it;
             int width = reg.getWidth();
             int prev_position = 0;
             string reverse_order;
@@ -697,26 +726,40 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
              // decl << indent(-1) << "} bits;" << endl;
         }
 
-        decl << "#ifdef CXX_SIMULATOR" << endl;
-        decl << indent() << "/** @brief Register name for use with the simulator. */" << endl;
-        decl << indent() << "const char* getName(void) { return \"" << camelcase(regname) << "\"; }" << endl << endl;
+        if(width <= 64)
+        {
+            decl << "#ifdef CXX_SIMULATOR" << endl;
+            decl << indent() << "/** @brief Register name for use with the simulator. */" << endl;
+            decl << indent() << "const char* getName(void) { return \"" << camelcase(regname) << "\"; }" << endl << endl;
 
-        decl << indent() << "/** @brief Print register value. */" << endl;
-        decl << indent() << "void print(void) { r" << width << ".print(); }" << endl << endl;
+            decl << indent() << "/** @brief Print register value. */" << endl;
+            decl << indent() << "void print(void) { r" << width << ".print(); }" << endl << endl;
 
-        decl << indent() << registerType << "()" << endl;
-        decl << indent() << "{" << endl;
-        indent(1);
-        decl << serialize_register_constructor(component, reg);
-        indent(-1);
-        decl << indent() << "}" << endl;
-        decl << indent() <<  registerType << "& operator=(const " << registerType << "& other)" << endl;
-        decl << indent() << "{" << endl;
-        decl << indent(1) << "r" << width << " = other.r" << width << ";" << endl;
-        decl << indent() << "return *this;" << endl;
-        indent(-1);
-        decl << indent() << "}" << endl;
-        decl << "#endif /* CXX_SIMULATOR */" << endl;
+            decl << indent() << registerType << "()" << endl;
+            decl << indent() << "{" << endl;
+            indent(1);
+            decl << serialize_register_constructor(component, reg);
+            indent(-1);
+            decl << indent() << "}" << endl;
+            decl << indent() <<  registerType << "& operator=(const " << registerType << "& other)" << endl;
+            decl << indent() << "{" << endl;
+            decl << indent(1) << "r" << width << " = other.r" << width << ";" << endl;
+            decl << indent() << "return *this;" << endl;
+            indent(-1);
+            decl << indent() << "}" << endl;
+            decl << "#endif /* CXX_SIMULATOR */" << endl;
+        }
+        else
+        {
+            // Wide registers are simulated one 64bit word at a time.
+            decl << "#ifdef CXX_SIMULATOR" << endl;
+            decl << indent() << "/** @brief Register name for use with the simulator. */" << endl;
+            decl << indent() << "const char* getName(void) { return \"" << camelcase(regname) << "\"; }" << endl << endl;
+
+            decl << indent() << "/** @brief Print register value. */" << endl;
+            decl << indent() << "void print(void) { for(int i = 0; i < " << std::dec << word_count(width) << "; i++) { r64[i].print(); } }" << endl;
+            decl << "#endif /* CXX_SIMULATOR */" << endl;
+        }
 
         decl << indent(-1) << "} " << registerType << ";" << endl << endl;
     }
@@ -726,83 +769,20 @@ string HeaderWriter::serialize_register_definition(Component& component, Registe
 
 string& HeaderWriter::escapeEnum(std::string& str)
 {
-    while(str.find(" ") != std::string::npos)
-    {
-        str.replace(str.find(" "), 1, ""); // Replace @'s with _AT_'s.
-    }
-
-    return escape(str);
+    str = Mangler::get(str, Mangler::Enumerator);
+    return str;
 }
 
 
 string& HeaderWriter::escape(std::string& str)
 {
-    std::replace(str.begin(), str.end(), ' ', '_'); // No spaces allowed
-    std::replace(str.begin(), str.end(), '-', '_'); // Replace -'s with _'s
-    std::replace(str.begin(), str.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(str.begin(), str.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(str.begin(), str.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(str.begin(), str.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(str.begin(), str.end(), ']', '_'); // Replace ]'s with _'s
-
-    while(str.find("—") != std::string::npos)
-    {
-        str.replace(str.find("—"), strlen("—"), "_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("@") != std::string::npos)
-    {
-        str.replace(str.find("@"), 1, "_AT_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("/") != std::string::npos)
-    {
-        str.replace(str.find("/"), 1, "_DIV_"); // Replace /'s with _DIV_'s.
-    }
-
+    str = Mangler::get(str, Mangler::Identifier);
     return str;
 }
 
 string HeaderWriter::camelcase(const string& str)
 {
-    string newstring = str;
-    std::replace(newstring.begin(), newstring.end(), ' ', '_'); // No spaces allowed
-    std::replace(newstring.begin(), newstring.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(newstring.begin(), newstring.end(), ']', '_'); // Replace ]'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '-', '_'); // Replace -'s with _'s
-
-    while(newstring.find("—") != std::string::npos)
-    {
-        newstring.replace(newstring.find("—"), strlen("—"), "_"); // Replace -'s with _'s.
-    }
-
-    ostringstream camelstr;
-    size_t srcpos = 0;
-    bool needscap = true;
-    for(srcpos = 0; srcpos < newstring.length(); srcpos++)
-    {
-        if(newstring[srcpos] == '_')
-        {
-            // do nothing, drop char.
-            needscap = true;
-        }
-        else
-        {
-            if(needscap)
-            {
-                camelstr << (char)toupper(newstring[srcpos]);
-            }
-            else
-            {
-                camelstr << (char)tolower(newstring[srcpos]);
-            }
-            needscap = false;
-        }
-    }
-    return camelstr.str();
+    return Mangler::get(str, Mangler::CamelCase);
 }
 
 string HeaderWriter::serialize_register_declaration(Component& component, Register& reg)
@@ -818,7 +798,7 @@ string HeaderWriter::serialize_register_declaration(Component& component, Regist
     if(isdigit(regname[0]))
     {
         newname = string("_") + newname;
-        cout << "Invalid: " << newname << endl;
+        Diagnostics::info("Invalid: %s", newname.c_str());
         // exit(-1);
     }
 
@@ -843,8 +823,8 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
     string componentType = get_type_name(component);
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
     decl <<  "#define REG_" << componentname << "_BASE" << " ((volatile void*)0x" << std::hex << (component.getBase()) * (component.getAddressUnitBits() / 8u) << ") /* " << component.getDescription() << " */" << endl;
     if(component.getRange())
@@ -863,7 +843,6 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_definition(component, *reg);
         }
     }
@@ -902,11 +881,11 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
                     {
                         if(prevreg)
                         {
-                            fprintf(stdout, "Info: adding %d bytes of padding between register %s and %s.\n", padding, prevreg->getName().c_str(), reg->getName().c_str());
+                            Diagnostics::info("Info: adding %d bytes of padding between register %s and %s.", padding, prevreg->getName().c_str(), reg->getName().c_str());
                         }
                         else
                         {
-                            fprintf(stdout, "Info: adding %d bytes of padding before first register %s.\n", padding, reg->getName().c_str());
+                            Diagnostics::info("Info: adding %d bytes of padding before first register %s.", padding, reg->getName().c_str());
                         }
                         int padwidth = component.getAddressUnitBits();
                         // 8 -> 16
@@ -924,10 +903,6 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
 
                         }
 
-                        cout << indent() << "/** @brief " << "Reserved bytes to pad out data structure." << " */" << endl;
-                        cout << indent() << type(padwidth, false) << " reserved_" << std::dec << expStart << "[" << padding << "];" << endl;
-
-
                         decl << indent() << "/** @brief " << "Reserved bytes to pad out data structure." << " */" << endl;
                         decl << indent() << type(padwidth, false) << " reserved_" << std::dec << expStart << "[" << padding << "];" << endl;
                         decl << endl;
@@ -936,19 +911,18 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
                     {
                         if(prevreg)
                         {
-                            fprintf(stderr, "Error: requested %d bytes of padding between component '%s' registers '%s' and '%s'.\n",
+                            Diagnostics::error("Error: requested %d bytes of padding between component '%s' registers '%s' and '%s'.\n",
                                 padding, componentname.c_str(), prevreg->getName().c_str(), reg->getName().c_str());
                         }
                         else
                         {
-                            fprintf(stderr, "Error: requested %d bytes of padding before component %s's first register '%s'.\n",
+                            Diagnostics::error("Error: requested %d bytes of padding before component %s's first register '%s'.\n",
                                 padding, componentname.c_str(), reg->getName().c_str());
                         }
                         while(1);
                     }
                 }
 
-                reg->sort();
                 decl << serialize_register_declaration(component, *reg);
             }
             prevreg = reg;
@@ -1021,34 +995,47 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
                 if(isdigit(regname[0]))
                 {
                     newname = string("_") + newname;
-                    cout << "Invalid: " << newname << endl;
+                    Diagnostics::info("Invalid: %s", newname.c_str());
                     // exit(-1);
                 }
 
-                if(dim > 1)
+                // Wide registers are an array of 64bit words, each word
+                // is placed individually.
+                int words = word_count(width);
+                for(int word = 0; word < words; word++)
                 {
-                    string basename = newname + string("[i].r") + to_string(width);
-                    decl << indent() << "for(int i = 0; i < " << std::dec << dim << "; i++)" << endl;
-                    decl << indent() << "{" << endl;
-                    indent(1);
-                    if(!reg->getTypeID().empty())
+                    string wordname = string(".r") + to_string(word_width(width));
+                    uint64_t wordaddr = reg->getAddr() + word * (word_width(width) / 8);
+                    if(words > 1)
                     {
-                        // Override the .r32 name to match the variable.
-                        decl << indent() << basename << ".setName(\"" << newname << "\");" << endl;
+                        wordname += "[" + to_string(word) + "]";
                     }
-                    decl << indent() << basename << ".setComponentOffset(0x" << std::hex << reg->getAddr() << " + (i * " << to_string(width/8) << "));" << endl;
-                    decl << indent(-1) << "}" << endl;
 
-                }
-                else
-                {
-                    string basename = newname + string(".r") + to_string(width);
-                    if(!reg->getTypeID().empty())
+                    if(dim > 1)
                     {
-                        // Override the .r32 name to match the variable.
-                        decl << indent() << basename << ".setName(\"" << newname << "\");" << endl;
+                        string basename = newname + string("[i]") + wordname;
+                        decl << indent() << "for(int i = 0; i < " << std::dec << dim << "; i++)" << endl;
+                        decl << indent() << "{" << endl;
+                        indent(1);
+                        if(!reg->getTypeID().empty())
+                        {
+                            // Override the .r32 name to match the variable.
+                            decl << indent() << basename << ".setName(\"" << newname << "\");" << endl;
+                        }
+                        decl << indent() << basename << ".setComponentOffset(0x" << std::hex << wordaddr << " + (i * " << to_string(width/8) << "));" << endl;
+                        decl << indent(-1) << "}" << endl;
+
+                    }
+                    else
+                    {
+                        string basename = newname + wordname;
+                        if(!reg->getTypeID().empty())
+                        {
+                            // Override the .r32 name to match the variable.
+                            decl << indent() << basename << ".setName(\"" << newname << "\");" << endl;
+                        }
+                        decl << indent() << basename << ".setComponentOffset(0x" << std::hex << wordaddr << ");" << endl;
                     }
-                    decl << indent() << basename << ".setComponentOffset(0x" << std::hex << reg->getAddr() << ");" << endl;
                 }
             }
         }
@@ -1111,7 +1098,7 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
                 if(isdigit(regname[0]))
                 {
                     newname = string("_") + newname;
-                    cout << "Invalid: " << newname << endl;
+                    Diagnostics::info("Invalid: %s", newname.c_str());
                     // exit(-1);
                 }
 
@@ -1147,40 +1134,20 @@ std::string HeaderWriter::serialize_component_declaration(Component& component)
     return decl.str();
 }
 
-void HeaderWriter::strreplace(string& origstr, const string& find, const string& replace)
+bool HeaderWriter::write(const CompiledModel& model)
 {
-    if(replace == find) return;
+    const Components& components = model.getComponents();
 
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool HeaderWriter::write(Components& components)
-{
-    bool status = true;
-
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
-    for(it = componentList.begin(); it != componentList.end(); it++)
-    {
-        Component* component = *it;
-        if(component)
-        {
-            status = status && writeComponent(*component);
-        }
-    }
-    return status;
+    return writeComponents(components, [this](Component& component) {
+        return writeComponent(component);
+    });
 }
 
 bool HeaderWriter::writeComponent(Component &component)
 {
     const string& componentname = component.getName();
-    string* header_contents = new RESOURCE_STRING(resources_HeaderWriter_h);
+    static const Template header(RESOURCE_STRING(resources_HeaderWriter_h));
 
-    string oldFIlename = mFilename;
     string filename = getComponentFile(componentname.c_str());
 
     string includePaths = "";
@@ -1189,15 +1156,15 @@ bool HeaderWriter::writeComponent(Component &component)
         includePaths = "#include \"" + getComponentFile(component.getTypeIDCopy().c_str()) + "\"\n";
     }
 
-    mFilename = strdup(filename.c_str());
+    HeaderWriter writer(filename);
 
+    Template::Values values;
+    FillTemplate(values, filename, component);
+    values["INCLUDES"] = includePaths;
+    values["SERIALIZED"] = writer.serialize_component_declaration(component);
 
-    component.sort();
-    strreplace(*header_contents, "<INCLUDES>", includePaths);
-    UpdateTemplate(*header_contents, filename, component);
-    strreplace(*header_contents, "<SERIALIZED>", serialize_component_declaration(component));
-    strreplace(*header_contents, "<INIT_FUNCTIONS>", serialize_component_declaration(component));
+    string header_contents;
+    header.render(values, header_contents);
 
-    mFilename = strdup(oldFIlename.c_str());
-    return WriteToFile(filename, *header_contents);
+    return WriteToFile(filename, header_contents);
 }
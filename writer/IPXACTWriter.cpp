@@ -61,7 +61,7 @@ IPXACTWriter::~IPXACTWriter()
 
 }
 
-void IPXACTWriter::serialize_bitmap_definition(xml_node& elem, RegisterBitmap& bitmap, int regwidth)
+void IPXACTWriter::serialize_bitmap_definition(xml_node& elem, const CompiledModel& model, size_t bitmap, int regwidth)
 {
 
 
@@ -116,7 +116,7 @@ pugi::xml_node IPXACTWriter::insertElement(pugi::xml_node& elem, const string& n
 	return newelem;
 }
 
-pugi::xml_node IPXACTWriter::insertElement(pugi::xml_node& elem, const string& name, unsigned int value)
+pugi::xml_node IPXACTWriter::insertElement(pugi::xml_node& elem, const string& name, uint64_t value)
 {
 	ostringstream valstr;
 	valstr << "0x" << std::hex << value;
@@ -124,37 +124,31 @@ pugi::xml_node IPXACTWriter::insertElement(pugi::xml_node& elem, const string& n
 	return insertElement(elem, name, valstr.str());
 }
 
-void IPXACTWriter::serialize_bitmap_declaration(xml_node& elem, RegisterBitmap& bitmap, int regwidth)
+void IPXACTWriter::serialize_bitmap_declaration(xml_node& elem, const CompiledModel& model, size_t bitmap, int regwidth)
 {
 	xml_node field = insertElement(elem, "ipxact:field");
 	// xml_node doc = elem.root();
 
 
 	//field
-	insertElement(field, "ipxact:name", bitmap.getName());
-	insertElement(field, "ipxact:description", bitmap.getDescription());
-	insertElement(field, "ipxact:bitOffset", bitmap.getStop());
-	insertElement(field, "ipxact:bitWidth", bitmap.getStart() - bitmap.getStop() + 1);
-	insertElement(field, "ipxact:access", registerType(bitmap.getType()));
+	insertElement(field, "ipxact:name", model.getFieldName(bitmap));
+	insertElement(field, "ipxact:description", model.getFieldDescription(bitmap));
+	insertElement(field, "ipxact:bitOffset", model.getFieldStop(bitmap));
+	insertElement(field, "ipxact:bitWidth", model.getFieldStart(bitmap) - model.getFieldStop(bitmap) + 1);
+	insertElement(field, "ipxact:access", registerType(model.getFieldType(bitmap)));
 
 
-	if(!bitmap.get().empty())
+	const CompiledModel::Range& bits = model.getFieldEnumerations(bitmap);
+	if(!bits.empty())
 	{
 		xml_node enums = insertElement(field, "ipxact:enumeratedValues");
 		field.insert_child_before(pugi::node_comment, enums).set_value(" LINK: enumeratedValue: see 6.11.10, Enumeration values ");
 
-		const std::list<Enumeration*>& bits = bitmap.get();
-		std::list<Enumeration*>::const_iterator bits_it;
-		for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
+		for(size_t bit = bits.begin(); bit != bits.end(); bit++)
 		{
-			Enumeration* bit = *bits_it;
-			if(bit)
-			{
-				xml_node thisenum = insertElement(enums, "ipxact:enumeratedValue");
-				insertElement(thisenum, "ipxact:name", bit->getName());
-				insertElement(thisenum, "ipxact:value", bit->getValue());
-
-			}
+			xml_node thisenum = insertElement(enums, "ipxact:enumeratedValue");
+			insertElement(thisenum, "ipxact:name", model.getEnumerationName(bit));
+			insertElement(thisenum, "ipxact:value", model.getEnumerationValue(bit));
 		}
 	}
 
@@ -189,73 +183,64 @@ void IPXACTWriter::serialize_bitmap_declaration(xml_node& elem, RegisterBitmap&
 
 }
 
-void IPXACTWriter::serialize_register_definition(xml_node& elem, Register& reg)
+void IPXACTWriter::serialize_register_definition(xml_node& elem, const CompiledModel& model, size_t reg)
 {
 
 
 }
 
-void IPXACTWriter::serialize_register_declaration(xml_node& elem, Register& reg)
+void IPXACTWriter::serialize_register_declaration(xml_node& elem, const CompiledModel& model, size_t reg)
 {
 	xml_node addr = insertElement(elem, "ipxact:register");
 	elem.insert_child_before(pugi::node_comment, addr).set_value(" LINK: registerDefinitionGroup: see 6.11.3, Register definition group ");
 
-	insertElement(addr, "ipxact:name", reg.getName());
-	insertElement(addr, "ipxact:description", reg.getDescription());
+	insertElement(addr, "ipxact:name", model.getRegisterName(reg));
+	insertElement(addr, "ipxact:description", model.getRegisterDescription(reg));
 
 	ostringstream hexAddr;
-	hexAddr << "0x" << std::hex << reg.getAddr();
+	hexAddr << "0x" << std::hex << model.getRegisterAddr(reg);
 	insertElement(addr, "ipxact:addressOffset", hexAddr.str());
 
-	if(!reg.getTypeID().empty())
+	if(!model.getRegisterTypeID(reg).empty())
 	{
-		insertElement(addr, "ipxact:typeIdentifier", reg.getTypeID());
+		insertElement(addr, "ipxact:typeIdentifier", model.getRegisterTypeID(reg));
 	}
 
-	if(reg.getDimensions() > 1)
+	if(model.getRegisterDimensions(reg) > 1)
 	{
 		ostringstream hexDims;
-		hexDims << "0x" << std::hex << reg.getDimensions();
+		hexDims << "0x" << std::hex << model.getRegisterDimensions(reg);
 		insertElement(addr, "ipxact:dim", hexDims.str());
 	}
 
-	insertElement(addr, "ipxact:size", reg.getWidth());
+	insertElement(addr, "ipxact:size", model.getRegisterWidth(reg));
 	insertElement(addr, "ipxact:volatile", "true");
 
 	// <ipxact:access>read-writeOnce</ipxact:access>
 
 
-	if(!reg.get().empty())
+	const CompiledModel::Range& bits = model.getRegisterFields(reg);
+	for(size_t bit = bits.begin(); bit != bits.end(); bit++)
 	{
-		const std::list<RegisterBitmap*>& bits = reg.get();
-		std::list<RegisterBitmap*>::const_iterator bits_it;
-		for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
-		{
-			RegisterBitmap* bit = *bits_it;
-			if(bit)
-			{
-				bit->sort();
-				serialize_bitmap_declaration(addr, *bit, reg.getWidth());
-			}
-		}
+		serialize_bitmap_declaration(addr, model, bit, model.getRegisterWidth(reg));
 	}
 }
 
-void IPXACTWriter::serialize_component_declaration(xml_node& elem, Component& component)
+void IPXACTWriter::serialize_component_declaration(xml_node& elem, const CompiledModel& model, size_t component)
 {
 	// xml_node& doc = elem.root();
 	xml_node map  = insertElement(elem, "ipxact:memoryMap");
-	insertElement(map, "ipxact:name", component.getName());
-	insertElement(map, "ipxact:description", component.getDescription());
+	insertElement(map, "ipxact:name", model.getComponentName(component));
+	insertElement(map, "ipxact:description", model.getComponentDescription(component));
 
 
 	xml_node addr = insertElement(map, "ipxact:addressBlock");
 	elem.insert_child_before(pugi::node_comment, addr).set_value(" LINK: addressBlockDefinitionGroup: see 6.9.3, Address blockdefinition group ");
-	insertElement(addr, "ipxact:name", component.getName());
-	insertElement(addr, "ipxact:description", component.getDescription());
+	insertElement(addr, "ipxact:name", model.getComponentName(component));
+	insertElement(addr, "ipxact:description", model.getComponentDescription(component));
 
 	ostringstream hexAddr;
-	hexAddr << "0x" << std::hex << component.getBase();
+	hexAddr << "0x" << std::hex << model.getComponentBase(component);
 	insertElement(addr, "ipxact:baseAddress", hexAddr.str());
 
 	// ipxact:range
@@ -264,15 +249,15 @@ void IPXACTWriter::serialize_component_declaration(xml_node& elem, Component& co
 	// ipxact:width
 	//insertElement(addr, "ipxact:width", ??);
 
-	if(!component.getTypeID().empty())
+	if(!model.getComponentTypeID(component).empty())
 	{
-		insertElement(addr, "ipxact:typeIdentifier", component.getTypeID());
+		insertElement(addr, "ipxact:typeIdentifier", model.getComponentTypeID(component));
 	}
 
 	// if(component.getRange())
 	{
 		ostringstream hexRange;
-		hexRange << "0x" << std::hex << component.getRange();
+		hexRange << "0x" << std::hex << model.getComponentRange(component);
 		insertElement(addr, "ipxact:range", hexRange.str());
 	}
 
@@ -280,28 +265,22 @@ void IPXACTWriter::serialize_component_declaration(xml_node& elem, Component& co
 	insertElement(addr, "ipxact:volatile", "false");
 
 
-    if(!component.isTypeIDCopy())
+    if(!model.isComponentTypeIDCopy(component))
 	{
-		const std::list<Register*>& regs = component.get();
-		std::list<Register*>::const_iterator it;
-		for(it = regs.begin(); it != regs.end(); it++)
+		const CompiledModel::Range& regs = model.getComponentRegisters(component);
+		for(size_t reg = regs.begin(); reg != regs.end(); reg++)
 		{
-			Register* reg = *it;
-			if(reg)
-			{
-				reg->sort();
-				serialize_register_declaration(addr, *reg);
-			}
+			serialize_register_declaration(addr, model, reg);
 		}
 	}
 
-	insertElement(map, "ipxact:addressUnitBits", component.getAddressUnitBits());
+	insertElement(map, "ipxact:addressUnitBits", model.getComponentAddressUnitBits(component));
 
 }
 
 
 
-bool IPXACTWriter::write(Components& components)
+bool IPXACTWriter::write(const CompiledModel& model)
 {
 	xml_document doc;
 	xml_node decl = doc.prepend_child(pugi::node_declaration);
@@ -319,20 +298,13 @@ bool IPXACTWriter::write(Components& components)
 	insertElement(root, "ipxact:name", "Register Definitions");
 	insertElement(root, "ipxact:version", "1.0");
 
-	if(!components.get().empty())
+	if(model.getComponentCount())
 	{
 		xml_node maps = 	insertElement(root, "ipxact:memoryMaps");
 
-        const std::list<Component*> &componentList = components.get();
-        std::list<Component*>::const_iterator it;
-        for(it = componentList.begin(); it != componentList.end(); it++)
+		for(size_t component = 0; component < model.getComponentCount(); component++)
 		{
-			Component* component = *it;
-			if(component) 
-			{
-				component->sort();
-				serialize_component_declaration(maps, *component);
-			}
+			serialize_component_declaration(maps, model, component);
 		}
 	}
 
@@ -45,6 +45,8 @@
 #include <LaTeXWriter.hpp>
 #include <Register.hpp>
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <Mangler.hpp>
 #include <string.h>
 
 #include <map>
@@ -90,27 +92,7 @@ std::string LaTeXWriter::accessType(RegisterBitmap::Type type) const
 
 std::string LaTeXWriter::escape(const std::string instring) const
 {
-    std::string outstring = instring;
-
-
-    unsigned int i = 0;
-    while(i < outstring.length())
-    {
-        if(outstring[i] == '_')
-        {
-            outstring.replace(i, 1, "\\_");
-            i++;
-        }
-        else if(outstring[i] == '$')
-        {
-            outstring.replace(i, 1, "\\$");
-            i++; 
-        }
-        i++;
-    }
-
-
-    return outstring;
+    return Mangler::get(instring, Mangler::LaTeX);
 }
 
 std::string LaTeXWriter::indent(int modifier)
@@ -127,15 +109,15 @@ std::string LaTeXWriter::indent(int modifier)
 
 static bool enums_mutually_exclusive(RegisterBitmap& bitmap)
 {
-    unsigned int usedbits = 0;
-    const std::list<Enumeration*>& bits = bitmap.get();
-    std::list<Enumeration*>::const_iterator bits_it;
+    uint64_t usedbits = 0;
+    const std::vector<Enumeration*>& bits = bitmap.get();
+    std::vector<Enumeration*>::const_iterator bits_it;
     for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
     {
         Enumeration* thisenum = *bits_it;
         if(thisenum)
         {
-            unsigned int value = thisenum->getValue();
+            uint64_t value = thisenum->getValue();
 
             if(usedbits & value || value == 0)
             {
@@ -160,7 +142,7 @@ static bool enums_mutually_exclusive(RegisterBitmap& bitmap)
 string LaTeXWriter::serialize_enum_definition(Component& component, Register& reg, RegisterBitmap& bitmap, Enumeration& thisenum)
 {
     string enumname = thisenum.getName();
-    unsigned int value = thisenum.getValue();
+    uint64_t value = thisenum.getValue();
 
     //std::transform(enumname.begin(), enumname.end(), enumname.begin(), ::toupper);
 
@@ -234,17 +216,16 @@ string LaTeXWriter::serialize_bitmap_definition(Component& component, Register&
             decl << endl;
         }
 
-        const std::list<Enumeration*>& bits = bitmap.get();
-        std::list<Enumeration*>::const_iterator bits_it;
+        const std::vector<Enumeration*>& bits = bitmap.get();
+        std::vector<Enumeration*>::const_iterator bits_it;
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
             Enumeration* thisenum = *bits_it;
             if(thisenum)
             {
-                std::list<Enumeration*>::const_iterator next_it = bits_it;
+                std::vector<Enumeration*>::const_iterator next_it = bits_it;
                 next_it++;
                 // FIXME: determine if all enums occupy one bit only. if so, chagne to a bitmap type enum (output as [V] instead of 0xV:)
-                thisenum->sort();
                 string out = serialize_enum_definition(component, reg, bitmap, *thisenum);
                 if(out.size())
                 {
@@ -310,26 +291,25 @@ string LaTeXWriter::serialize_register_definition(Component& component, Register
 #endif
     if(!reg.get().empty())
     {
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_reverse_iterator bits_it;
+        const std::vector<RegisterBitmap*>& bits = reg.get();
+        std::vector<RegisterBitmap*>::const_reverse_iterator bits_it;
         for(bits_it = bits.rbegin(); bits_it != bits.rend(); bits_it++)
         {
             RegisterBitmap* bit = *bits_it;
             if(bit)
             {
-                bit->sort();
                 decl << serialize_bitmap_definition(component, reg, *bit, reg.getWidth());
             }
         }
     }
     else
     {
-        RegisterBitmap* bit = new RegisterBitmap("r32");
-        bit->setDescription("Direct access to the register data.");
-        bit->setStart(reg.getWidth() - 1);
-        bit->setStop(0);
-        bit->setType(RegisterBitmap::ReadWrite);
-        decl << serialize_bitmap_definition(component, reg, *bit, reg.getWidth());
+        RegisterBitmap bit("r32");
+        bit.setDescription("Direct access to the register data.");
+        bit.setStart(reg.getWidth() - 1);
+        bit.setStop(0);
+        bit.setType(RegisterBitmap::ReadWrite);
+        decl << serialize_bitmap_definition(component, reg, bit, reg.getWidth());
     }
 
     decl << indent(-1) <<"\\end{longtabu}" << endl;
@@ -364,15 +344,14 @@ string LaTeXWriter::serialize_register_definition(Component& component, Register
         indent(1);
 
 
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_iterator bits_it;
+        const std::vector<RegisterBitmap*>& bits = reg.get();
+        std::vector<RegisterBitmap*>::const_iterator bits_it;
         int width = reg.getWidth();
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
             RegisterBitmap* bit = *bits_it;
             if(bit)
             {
-                bit->sort();
                 decl << serialize_bitmap_declaration(component, reg, *bit, width);
             }
         }
@@ -387,30 +366,7 @@ string LaTeXWriter::serialize_register_definition(Component& component, Register
 
 string LaTeXWriter::camelcase(const string& str)
 {
-    ostringstream camelstr;
-    size_t srcpos = 0;
-    bool needscap = true;
-    for(srcpos = 0; srcpos < str.length(); srcpos++)
-    {
-        if(str[srcpos] == '_')
-        {
-            // do nothing, drop char.
-            needscap = true;
-        }
-        else
-        {
-            if(needscap)
-            {
-                camelstr << (char)toupper(str[srcpos]);
-            }
-            else
-            {
-                camelstr << (char)tolower(str[srcpos]);
-            }
-            needscap = false;
-        }
-    }
-    return camelstr.str();
+    return Mangler::get(str, Mangler::Capitalized);
 }
 
 string LaTeXWriter::serialize_register_declaration(Component& component, Register& reg)
@@ -435,8 +391,8 @@ std::string    LaTeXWriter::serialize_component_declaration(Component& component
     const string& componentname = component.getName();
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
 
     decl << "\\section{" << componentname << "}" << endl;
@@ -450,7 +406,6 @@ std::string    LaTeXWriter::serialize_component_declaration(Component& component
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_definition(component, *reg);
         }
     }
@@ -458,25 +413,15 @@ std::string    LaTeXWriter::serialize_component_declaration(Component& component
     return decl.str();
 }
 
-void LaTeXWriter::strreplace(string& origstr, const string& find, const string& replace)
-{
-    if(replace == find) return;
-
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool LaTeXWriter::write(Components& components)
+bool LaTeXWriter::write(const CompiledModel& model)
 {
+    const Components& components = model.getComponents();
 
 
     ostringstream output;
 
-    string prefix(header_prefix);
-    string suffix(header_suffix);
+    static const Template prefix_template(header_prefix);
+    static const Template suffix_template(header_suffix);
 
     string guard(mFilename);
     std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
@@ -488,11 +433,15 @@ bool LaTeXWriter::write(Components& components)
     // <PROJECT>
     // <DESCRIPTION>
     // <GUARD>
-    strreplace(prefix, "<FILE>", mFilename);
-    strreplace(prefix, "<PROJECT>", (*gOptions)["project"].c_str());
-    strreplace(prefix, "<GUARD>", guard);
+    Template::Values values;
+    values["FILE"] = mFilename;
+    values["PROJECT"] = (*gOptions)["project"];
+    values["GUARD"] = guard;
 
-    strreplace(suffix, "<GUARD>", guard);
+    string prefix;
+    string suffix;
+    prefix_template.render(values, prefix);
+    suffix_template.render(values, suffix);
 
     output << prefix;
 
@@ -508,17 +457,16 @@ bool LaTeXWriter::write(Components& components)
     output << indent() << "\\hline % Ensure end of table has a line" << endl;
     output << indent() << "\\endfoot" << endl;
 
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
+    const std::vector<Component*> &componentList = components.get();
+    std::vector<Component*>::const_iterator it;
     for(it = componentList.begin(); it != componentList.end(); it++)
     {
         Component* component = *it;
         if(component)
         {
-            component->sort();
 
-            const std::list<Register*>& regs = component->get();
-            std::list<Register*>::const_iterator it;
+            const std::vector<Register*>& regs = component->get();
+            std::vector<Register*>::const_iterator it;
 
             for(it = regs.begin(); it != regs.end(); it++)
             {
@@ -527,7 +475,7 @@ bool LaTeXWriter::write(Components& components)
 
                 if(reg)
                 {
-                    std::list<Register*>::const_iterator next_it = it;
+                    std::vector<Register*>::const_iterator next_it = it;
                     next_it++;
 
 
@@ -566,7 +514,6 @@ bool LaTeXWriter::write(Components& components)
         Component* component = *it;
         if(component)
         {
-            component->sort();
             output << serialize_component_declaration(*component);
             output << endl;
         }
@@ -575,6 +522,5 @@ bool LaTeXWriter::write(Components& components)
     output << suffix;
 
     mFile << output.str();
-    cout << output.str();
     return true;
 }
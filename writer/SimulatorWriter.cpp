@@ -45,6 +45,8 @@
 #include <SimulatorWriter.hpp>
 #include <Register.hpp>
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <Mangler.hpp>
 #include <string.h>
 #include <resources.h>
 
@@ -64,6 +66,13 @@ SimulatorWriter::SimulatorWriter(const char* filename) : Writer(filename)
     mIndent = 0;
 }
 
+// Writer for one component, with its own indentation.
+SimulatorWriter::SimulatorWriter(const SimulatorWriter& parent) : Writer()
+{
+    mFilename = strdup(parent.mFilename);
+    mIndent = 0;
+}
+
 SimulatorWriter::~SimulatorWriter()
 {
     if(mFilename) free(mFilename);
@@ -128,8 +137,9 @@ std::string SimulatorWriter::type(int width, bool isSigned) const
         case  8: regtype += "int8_t"; break;
         case 16: regtype += "int16_t"; break;
         case 32: regtype += "int32_t"; break;
+        case 64: regtype += "int64_t"; break;
         default:
-            fprintf(stderr, "Error: unable to handle a register width of %d, please use 8, 16, or 32.\n", width);
+            Diagnostics::error("Error: unable to handle a register width of %d, please use 8, 16, 32, or 64.", width);
             break;
     }
 
@@ -165,7 +175,7 @@ string SimulatorWriter::serialize_bitmap_declaration(Component& component, Regis
     if(isdigit(regname[0]))
     {
         newname = string("_") + newname;
-        cout << "Invalid: " << newname << endl;
+        Diagnostics::info("Invalid: %s", newname.c_str());
         // exit(-1);
     }
 
@@ -193,8 +203,8 @@ string SimulatorWriter::serialize_register_definition(Component& component, Regi
 
     if(!reg.get().empty())
     {
-        const std::list<RegisterBitmap*>& bits = reg.get();
-        std::list<RegisterBitmap*>::const_iterator bits_it;
+        const std::vector<RegisterBitmap*>& bits = reg.get();
+        std::vector<RegisterBitmap*>::const_iterator bits_it;
         int width = reg.getWidth();
         for(bits_it = bits.begin(); bits_it != bits.end(); bits_it++)
         {
@@ -241,11 +251,11 @@ string SimulatorWriter::serialize_register_mmap_definition(Component& component,
         {
             if(prevreg)
             {
-                fprintf(stdout, "Info: adding %d bytes of padding between register %s and %s.\n", padding, prevreg->getName().c_str(), reg.getName().c_str());
+                Diagnostics::info("Info: adding %d bytes of padding between register %s and %s.", padding, prevreg->getName().c_str(), reg.getName().c_str());
             }
             else
             {
-                fprintf(stdout, "Info: adding %d bytes of padding before first register %s.\n", padding, reg.getName().c_str());
+                Diagnostics::info("Info: adding %d bytes of padding before first register %s.", padding, reg.getName().c_str());
             }
             if(0 == padding % 4)
             {
@@ -268,12 +278,12 @@ string SimulatorWriter::serialize_register_mmap_definition(Component& component,
         {
             if(prevreg)
             {
-                fprintf(stderr, "Error: requested %d bytes of padding between component type '%s' registers '%s' and '%s'.\n",
+                Diagnostics::error("Error: requested %d bytes of padding between component type '%s' registers '%s' and '%s'.\n",
                     padding, componentType.c_str(), prevreg->getName().c_str(), reg.getName().c_str());
             }
             else
             {
-                fprintf(stderr, "Error: requested %d bytes of padding before component type %s's first register '%s'.\n",
+                Diagnostics::error("Error: requested %d bytes of padding before component type %s's first register '%s'.\n",
                     padding, componentType.c_str(), reg.getName().c_str());
             }
             while(1);
@@ -291,27 +301,44 @@ string SimulatorWriter::serialize_register_mmap_definition(Component& component,
     if(isdigit(regname[0]))
     {
         newname = string("_") + newname;
-        cout << "Invalid: " << newname << endl;
+        Diagnostics::info("Invalid: %s", newname.c_str());
         // exit(-1);
     }
 
-    int dim = reg.getDimensions();
-    if(dim > 1)
+    // Registers wider than 64 bits are an array of 64bit words.
+    int words = 1;
+    if(width > 64)
     {
-        string basename = string(component.getName()) + string(".") + newname + string("[i].r") + to_string(width);
-        decl << indent() << "for(int i = 0; i < " << dim << "; i++)" << endl;
-        decl << indent() << "{" << endl;
-        indent(1);
-        decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
-        decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
-        indent(-1);
-        decl << indent() << "}" << endl;
+        words = (width + 63) / 64;
+        width = 64;
     }
-    else
+
+    int dim = reg.getDimensions();
+    for(int word = 0; word < words; word++)
     {
-        string basename = string(component.getName()) + string(".") + newname + string(".r") + to_string(width);
-        decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
-        decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+        string wordname = string(".r") + to_string(width);
+        if(words > 1)
+        {
+            wordname += "[" + to_string(word) + "]";
+        }
+
+        if(dim > 1)
+        {
+            string basename = string(component.getName()) + string(".") + newname + string("[i]") + wordname;
+            decl << indent() << "for(int i = 0; i < " << dim << "; i++)" << endl;
+            decl << indent() << "{" << endl;
+            indent(1);
+            decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
+            decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+            indent(-1);
+            decl << indent() << "}" << endl;
+        }
+        else
+        {
+            string basename = string(component.getName()) + string(".") + newname + wordname;
+            decl << indent() << basename << ".installReadCallback(read, (uint8_t *)base);" << endl;
+            decl << indent() << basename << ".installWriteCallback(write, (uint8_t *)base);" << endl;
+        }
     }
 
     decl << endl;
@@ -322,83 +349,20 @@ string SimulatorWriter::serialize_register_mmap_definition(Component& component,
 
 string& SimulatorWriter::escapeEnum(std::string& str)
 {
-    while(str.find(" ") != std::string::npos)
-    {
-        str.replace(str.find(" "), 1, ""); // Replace @'s with _AT_'s.
-    }
-
-    return escape(str);
+    str = Mangler::get(str, Mangler::Enumerator);
+    return str;
 }
 
 
 string& SimulatorWriter::escape(std::string& str)
 {
-    std::replace(str.begin(), str.end(), ' ', '_'); // No spaces allowed
-    std::replace(str.begin(), str.end(), '-', '_'); // Replace -'s with _'s
-    std::replace(str.begin(), str.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(str.begin(), str.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(str.begin(), str.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(str.begin(), str.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(str.begin(), str.end(), ']', '_'); // Replace ]'s with _'s
-
-    while(str.find("—") != std::string::npos)
-    {
-        str.replace(str.find("—"), strlen("—"), "_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("@") != std::string::npos)
-    {
-        str.replace(str.find("@"), 1, "_AT_"); // Replace @'s with _AT_'s.
-    }
-
-    while(str.find("/") != std::string::npos)
-    {
-        str.replace(str.find("/"), 1, "_DIV_"); // Replace /'s with _DIV_'s.
-    }
-
+    str = Mangler::get(str, Mangler::Identifier);
     return str;
 }
 
 string SimulatorWriter::camelcase(const string& str)
 {
-    string newstring = str;
-    std::replace(newstring.begin(), newstring.end(), ' ', '_'); // No spaces allowed
-    std::replace(newstring.begin(), newstring.end(), '.', '_'); // Replace .'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ',', '_'); // Replace ,'s with _'s
-    std::replace(newstring.begin(), newstring.end(), ':', '_'); // Replace :'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '[', '_'); // Replace ['s with _'s
-    std::replace(newstring.begin(), newstring.end(), ']', '_'); // Replace ]'s with _'s
-    std::replace(newstring.begin(), newstring.end(), '-', '_'); // Replace -'s with _'s
-
-    while(newstring.find("—") != std::string::npos)
-    {
-        newstring.replace(newstring.find("—"), strlen("—"), "_"); // Replace -'s with _'s.
-    }
-
-    ostringstream camelstr;
-    size_t srcpos = 0;
-    bool needscap = true;
-    for(srcpos = 0; srcpos < newstring.length(); srcpos++)
-    {
-        if(newstring[srcpos] == '_')
-        {
-            // do nothing, drop char.
-            needscap = true;
-        }
-        else
-        {
-            if(needscap)
-            {
-                camelstr << (char)toupper(newstring[srcpos]);
-            }
-            else
-            {
-                camelstr << (char)tolower(newstring[srcpos]);
-            }
-            needscap = false;
-        }
-    }
-    return camelstr.str();
+    return Mangler::get(str, Mangler::CamelCase);
 }
 
 std::string    SimulatorWriter::serialize_component_declaration(Component& component)
@@ -406,8 +370,8 @@ std::string    SimulatorWriter::serialize_component_declaration(Component& compo
     const string& componentname = component.getName();
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
     decl << indent() << "/** @brief Component Registers for @ref " << componentname << ". */" << endl;
     for(it = regs.begin(); it != regs.end(); it++)
@@ -415,7 +379,6 @@ std::string    SimulatorWriter::serialize_component_declaration(Component& compo
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_definition(component, *reg);
         }
     }
@@ -428,8 +391,8 @@ std::string    SimulatorWriter::serialize_mmap_declaration(Component& component)
     const string& componentname = component.getName();
     ostringstream decl;
 
-    const std::list<Register*>& regs = component.get();
-    std::list<Register*>::const_iterator it;
+    const std::vector<Register*>& regs = component.get();
+    std::vector<Register*>::const_iterator it;
 
     decl << indent() << "/** @brief Component Registers for @ref " << componentname << ". */" << endl;
     Register* prevreg = NULL;
@@ -438,7 +401,6 @@ std::string    SimulatorWriter::serialize_mmap_declaration(Component& component)
         Register* reg = *it;
         if(reg)
         {
-            reg->sort();
             decl << serialize_register_mmap_definition(component, *reg, prevreg);
             prevreg = reg;
         }
@@ -447,32 +409,14 @@ std::string    SimulatorWriter::serialize_mmap_declaration(Component& component)
     return decl.str();
 }
 
-void SimulatorWriter::strreplace(string& origstr, const string& find, const string& replace)
-{
-    if(replace == find) return;
-
-    int findlen = find.length();
-    while (origstr.find(find) != string::npos)
-    {
-        origstr.replace(origstr.find(find), findlen, replace);
-    }
-}
-
-bool SimulatorWriter::write(Components& components)
+bool SimulatorWriter::write(const CompiledModel& model)
 {
-    bool status = true;
+    const Components& components = model.getComponents();
 
-    const std::list<Component*> &componentList = components.get();
-    std::list<Component*>::const_iterator it;
-    for(it = componentList.begin(); it != componentList.end(); it++)
-    {
-        Component* component = *it;
-        if(component)
-        {
-            status = status && writeComponent(*component);
-        }
-    }
-    return status;
+    return writeComponents(components, [this](Component& component) {
+        SimulatorWriter writer(*this);
+        return writer.writeComponent(component);
+    });
 }
 
 
@@ -484,20 +428,26 @@ bool SimulatorWriter::writeComponent(Component &component)
     string mmap_filename = getComponentMMAPFile(componentname.c_str());
 
 
-    string* file_contents = new RESOURCE_STRING(resources_SimulatorOutput_cpp);
-    string* mmap_contents = new RESOURCE_STRING(resources_SimulatorOutput_mmap_cpp);
+    static const Template file_template(RESOURCE_STRING(resources_SimulatorOutput_cpp));
+    static const Template mmap_template(RESOURCE_STRING(resources_SimulatorOutput_mmap_cpp));
 
 
     indent(1);
-    component.sort();
 
-    UpdateTemplate(*file_contents, filename, component);
-    strreplace(*file_contents, "<SERIALIZED>", serialize_component_declaration(component));
+    Template::Values values;
+    FillTemplate(values, filename, component);
+    values["SERIALIZED"] = serialize_component_declaration(component);
+
+    string file_contents;
+    file_template.render(values, file_contents);
+
+    FillTemplate(values, mmap_filename, component);
+    values["SERIALIZED"] = serialize_mmap_declaration(component);
 
-    UpdateTemplate(*mmap_contents, mmap_filename, component);
-    strreplace(*mmap_contents, "<SERIALIZED>", serialize_mmap_declaration(component));
+    string mmap_contents;
+    mmap_template.render(values, mmap_contents);
 
 
     indent(-1);
-    return WriteToFile(filename, *file_contents) && WriteToFile(mmap_filename, *mmap_contents);
+    return WriteToFile(filename, file_contents) && WriteToFile(mmap_filename, mmap_contents);
 }
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @file       source/Template.cpp
+///
+/// @project    ipxact
+///
+/// @brief      Output file templates.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// @copyright Copyright (c) 2019, Evan Lojewski
+/// @cond
+///
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without
+/// modification, are permitted provided that the following conditions are met:
+/// 1. Redistributions of source code must retain the above copyright notice,
+/// this list of conditions and the following disclaimer.
+/// 2. Redistributions in binary form must reproduce the above copyright notice,
+/// this list of conditions and the following disclaimer in the documentation
+/// and/or other materials provided with the distribution.
+/// 3. Neither the name of the <organization> nor the
+/// names of its contributors may be used to endorse or promote products
+/// derived from this software without specific prior written permission.
+///
+////////////////////////////////////////////////////////////////////////////////
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+/// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+/// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+/// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+/// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+/// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+/// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+/// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+/// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+/// POSSIBILITY OF SUCH DAMAGE.
+/// @endcond
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Template.hpp>
+
+using namespace std;
+
+static bool is_slot_char(char c)
+{
+    return (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+Template::Template(const string& text) : mText(text)
+{
+    size_t literal = 0;
+    size_t open = mText.find('<');
+    while(open != string::npos)
+    {
+        size_t close = open + 1;
+        while(close < mText.length() && is_slot_char(mText[close]))
+        {
+            close++;
+        }
+
+        if(close == open + 1 || close == mText.length() || mText[close] != '>')
+        {
+            open = mText.find('<', open + 1);
+            continue;
+        }
+
+        if(open > literal)
+        {
+            Segment segment = { literal, open - literal, "" };
+            mSegments.push_back(segment);
+        }
+
+        Segment slot = { open, close + 1 - open, mText.substr(open + 1, close - open - 1) };
+        mSegments.push_back(slot);
+
+        literal = close + 1;
+        open = mText.find('<', literal);
+    }
+
+    if(literal < mText.length())
+    {
+        Segment segment = { literal, mText.length() - literal, "" };
+        mSegments.push_back(segment);
+    }
+}
+
+void Template::render(const Values& values, string& output) const
+{
+    vector<const string*> replacements(mSegments.size(), NULL);
+    size_t size = output.length();
+    for(size_t i = 0; i < mSegments.size(); i++)
+    {
+        const Segment& segment = mSegments[i];
+        if(!segment.slot.empty())
+        {
+            Values::const_iterator value = values.find(segment.slot);
+            if(value != values.end())
+            {
+                replacements[i] = &value->second;
+                size += value->second.length();
+                continue;
+            }
+        }
+        size += segment.length;
+    }
+
+    output.reserve(size);
+    for(size_t i = 0; i < mSegments.size(); i++)
+    {
+        if(replacements[i])
+        {
+            output += *replacements[i];
+        }
+        else
+        {
+            output.append(mText, mSegments[i].begin, mSegments[i].length);
+        }
+    }
+}
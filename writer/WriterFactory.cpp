@@ -47,8 +47,14 @@
 #include <stdlib.h>
 #include <sstream>
 #include <ctime>
+#include <atomic>
+#include <thread>
+
+#include <unistd.h>
 
 #include <main.hpp>
+#include <Diagnostics.hpp>
+#include <OutputFile.hpp>
 
 
 #include <Writer.hpp>
@@ -63,85 +69,106 @@
 
 using namespace std;
 
+// Returns the last '.' separated part of the file name, or the override.
+static string file_type(const char* filename, const char* force_extension)
+{
+    if(force_extension)
+    {
+        return force_extension;
+    }
+
+    string name = filename;
+    size_t last = name.find_last_not_of('.');
+    if(last == string::npos)
+    {
+        return "";
+    }
+    name.erase(last + 1);
+
+    size_t dot = name.rfind('.');
+    return dot == string::npos ? name : name.substr(dot + 1);
+}
+
 Writer* WriterFactory::create(const char* filename, const char* force_extension)
 {
     Writer* myWriter = NULL;
-    char* file = strdup(filename);
-    char* saveptr;
-    char* partial = strtok_r(file, ".", &saveptr);
+    string type = file_type(filename, force_extension);
 
     // find file extension and return appropriate output writer.
-    do
-    {
-        char* next;
-        if(force_extension)
-        {
-            next = NULL;
-            partial = strdup(force_extension);
-        }
-        else
-        {
-            next = strtok_r(NULL, ".", &saveptr);
-        }
-
-        if(!next)
-        {
-            printf("Checking extension '%s'\n", partial);
+    Diagnostics::debug("Checking extension '%s'", type.c_str());
 
-            if(0 == strncmp("h", partial, sizeof("h")))
-            {
-                // header.
-                myWriter = new HeaderWriter(filename);
-            }
-            else if(0 == strncmp("xml", partial, sizeof("xml")))
-            {
-                // ipxact.
-                myWriter = new IPXACTWriter(filename);
-            }
-            else if(0 == strncmp("tex", partial, sizeof("tex")))
-            {
-                // ipxact.
-                myWriter = new LaTeXWriter(filename);
-            }
-            else if(0 == strncmp("asym", partial, sizeof("asym")))
-            {
-                // ipxact.
-                myWriter = new ASMSymbols(filename);
-            }
-            else if(0 == strncmp("s", partial, sizeof("s")))
-            {
-                // ipxact.
-                myWriter = new ASMWriter(filename);
-            }
-            else if(0 == strncmp("cpp", partial, sizeof("cpp")))
-            {
-                // Simulation / model.
-                myWriter = new SimulatorWriter(filename);
-            }
-            else if(0 == strncmp("ape_cpp", partial, sizeof("ape_cpp")))
-            {
-                // Simulation / Model.
-                myWriter = new APESimulatorWriter(filename);
-            }
-        }
-        partial = next;
-    } while(partial);
+    if("h" == type)
+    {
+        // header.
+        myWriter = new HeaderWriter(filename);
+    }
+    else if("xml" == type)
+    {
+        // ipxact.
+        myWriter = new IPXACTWriter(filename);
+    }
+    else if("tex" == type)
+    {
+        // ipxact.
+        myWriter = new LaTeXWriter(filename);
+    }
+    else if("asym" == type)
+    {
+        // ipxact.
+        myWriter = new ASMSymbols(filename);
+    }
+    else if("s" == type)
+    {
+        // ipxact.
+        myWriter = new ASMWriter(filename);
+    }
+    else if("cpp" == type)
+    {
+        // Simulation / model.
+        myWriter = new SimulatorWriter(filename);
+    }
+    else if("ape_cpp" == type)
+    {
+        // Simulation / Model.
+        myWriter = new APESimulatorWriter(filename);
+    }
 
-    free(file);
     return myWriter;
 }
 
+bool WriterFactory::usesDescriptions(const char* filename, const char* force_extension)
+{
+    string type = file_type(filename, force_extension);
+    return "asym" != type && "cpp" != type && "ape_cpp" != type;
+}
+
+
+Writer::Writer(const char* filename) : mOutputFile(filename)
+{
+}
 
-Writer::Writer(const char* filename)
+Writer::Writer()
 {
-    // Open output file
-    mFile.open(filename, ios::out | ios::binary);
 }
 
 Writer::~Writer()
 {
-    mFile.close();
+}
+
+bool Writer::is_open()
+{
+    size_t slash = mOutputFile.find_last_of('/');
+    string directory = slash == string::npos ? "." : mOutputFile.substr(0, slash + 1);
+
+    // Replaced by renaming, the directory has to be writable.
+    return !mOutputFile.empty() &&
+           access(directory.c_str(), W_OK) == 0 &&
+           (access(mOutputFile.c_str(), F_OK) != 0 || access(mOutputFile.c_str(), W_OK) == 0);
+}
 
+bool Writer::commit()
+{
+    return mOutputFile.empty() || OutputFile::write(mOutputFile, mFile.str());
 }
 
 static void strreplace(string& origstr, const string& find, const string& replace)
@@ -155,7 +182,7 @@ static void strreplace(string& origstr, const string& find, const string& replac
     }
 }
 
-void Writer::UpdateTemplate(std::string& contents, std::string& filename, Component &component)
+void Writer::FillTemplate(Template::Values& values, const std::string& filename, Component &component)
 {
     const string& componentname = component.getName();
     int componentSize = 0;
@@ -187,34 +214,34 @@ void Writer::UpdateTemplate(std::string& contents, std::string& filename, Compon
     }
 
 
-    strreplace(contents, "<COMPONENT>", componentname.c_str());
-    strreplace(contents, "<COMPONENT_TYPE>", type.c_str());
-    strreplace(contents, "<COMPONENT_SIZE>", std::to_string(componentSize));
+    values["COMPONENT"] = componentname;
+    values["COMPONENT_TYPE"] = type;
+    values["COMPONENT_SIZE"] = std::to_string(componentSize);
 
-    UpdateTemplate(contents, filename);
+    FillTemplate(values, filename);
 }
 
-void Writer::UpdateTemplate(std::string& contents, std::string& filename)
+void Writer::FillTemplate(Template::Values& values, const std::string& filename)
 {
     string guard(filename);
     std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
     std::replace(guard.begin(), guard.end(), '.', '_');
     std::replace(guard.begin(), guard.end(), '/', '_');
 
-    strreplace(contents, "<FILE>", filename);
-    strreplace(contents, "<PROJECT>", (*gOptions)["project"].c_str());
+    const optparse::Values& options = *gOptions;
+    values["FILE"] = filename;
+    values["PROJECT"] = options["project"];
 
-    static struct tm *timeinfo;
-    static char tbuf[5];
-    if (!timeinfo)
-    {
+    // Components may be written concurrently, set once.
+    static const string year = []() {
         time_t rawtime;
         time(&rawtime);
-        timeinfo = localtime(&rawtime);
 
-        strftime(tbuf, sizeof(tbuf), "%Y", timeinfo);
-    }
-    strreplace(contents, "<YEAR>", tbuf);
+        char tbuf[5];
+        strftime(tbuf, sizeof(tbuf), "%Y", localtime(&rawtime));
+        return string(tbuf);
+    }();
+    values["YEAR"] = year;
 
     string filename_strip = filename;
 
@@ -222,28 +249,87 @@ void Writer::UpdateTemplate(std::string& contents, std::string& filename)
     strreplace(filename_strip, ".cpp", "");
     strreplace(filename_strip, ".h", "");
 
-    strreplace(contents, "<INIT_FUNCTION>", filename_strip);
-    strreplace(contents, "<GUARD>", guard);
-    strreplace(contents, "<VOLATILE>", guard + "_VOLATILE");
+    values["INIT_FUNCTION"] = filename_strip;
+    values["GUARD"] = guard;
+    values["VOLATILE"] = guard + "_VOLATILE";
 
     ostringstream descstream;
     descstream << filename_strip;
     string description = descstream.str();
 
-    strreplace(contents, "<DESCRIPTION>", description);
+    values["DESCRIPTION"] = description;
 
     string includes = "#include <" + filename_strip + ".h>";
     strreplace(includes, "_sim", ""); // hack
-    strreplace(contents, "<INCLUDES>", includes);
+    values["INCLUDES"] = includes;
 }
 
-bool Writer::WriteToFile(string& filename, string& contents)
+// Components are written by up to --jobs threads, messages are held per
+// component and printed in list order. Components sharing registers with
+// another component are written afterwards on this thread.
+bool Writer::writeComponents(const Components& components, const std::function<bool(Component&)>& write)
 {
-    std::ofstream outFile;
-    outFile.open(filename, ios::out | ios::binary);
+    const std::vector<Component*>& list = components.get();
+    int jobs = gOptions->get("jobs");
+    bool parallel = jobs > 1 && list.size() > 1;
 
-    outFile << contents;
+    vector<char> shared(list.size(), false);
+    for(size_t i = 0; parallel && i < list.size(); i++)
+    {
+        shared[i] = list[i] && (list[i]->isTypeIDCopy() || list[i]->sharesRegisters());
+    }
+
+    vector<char> written(list.size(), false);
+    vector<char> status(list.size(), true);
+    vector<DiagnosticsCapture> messages(list.size());
+    if(parallel)
+    {
+        atomic<size_t> next(0);
+        vector<thread> workers;
+        for(int i = 0; i < jobs && (size_t)i < list.size(); i++)
+        {
+            workers.push_back(thread([&]() {
+                size_t index;
+                while((index = next++) < list.size())
+                {
+                    Component* component = list[index];
+                    if(component && !shared[index])
+                    {
+                        messages[index].start();
+                        status[index] = write(*component);
+                        messages[index].stop();
+                        written[index] = true;
+                    }
+                }
+            }));
+        }
+
+        for(size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+    }
+
+    bool result = true;
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        Component* component = list[i];
+        if(written[i])
+        {
+            messages[i].replay();
+            result = result && status[i];
+        }
+        else if(component && (parallel || result))
+        {
+            result = write(*component) && result;
+        }
+    }
+
+    return result;
+}
 
-    return outFile.good();
+bool Writer::WriteToFile(string& filename, string& contents)
+{
+    return OutputFile::write(filename, contents);
 }
 